@@ -0,0 +1,167 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+/* Client for `assembler --serve`. Takes the same --input_file,
+   --output_folder and --format options as the assembler and writes the
+   same .out and .log files, but the work is done by the resident server:
+
+     asm_client --serve SOCKET --input_file a.s [--input_file b.s ...]
+                --output_folder out/ [--format hex|bin|elf]
+
+   All inputs go over one connection. The exit status is 1 if any file had
+   errors or could not be assembled, as with the assembler.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "assembler.h"
+#include "src/protocol.h"
+
+#define MAX_PATH_LENGTH 512
+#define MAX_INPUTS 1024
+
+/* Reads the file at PATH into a malloc'd buffer; sets *LEN. */
+static char* read_source(const char* path, size_t* len) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+  char* buf = malloc(size > 0 ? (size_t)size : 1);
+  *len = 0;
+  if (buf && size > 0) {
+    *len = fread(buf, 1, (size_t)size, file);
+  }
+  fclose(file);
+  return buf;
+}
+
+/* Writes LEN bytes of DATA to FOLDER/<INPUT without extension>.EXT, where
+   the assembler would put them. */
+static int write_result(const char* input, const char* folder,
+                        const char* ext, const char* data, size_t len) {
+  const char* name = strrchr(input, '/');
+  name = name ? name + 1 : input;
+  const char* dot = strrchr(name, '.');
+  int base_len = dot ? (int)(dot - name) : (int)strlen(name);
+
+  char path[MAX_PATH_LENGTH];
+  snprintf(path, sizeof(path), "%s%.*s.%s", folder, base_len, name, ext);
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    return -1;
+  }
+  size_t written = fwrite(data, 1, len, file);
+  fclose(file);
+  return written == len ? 0 : -1;
+}
+
+int main(int argc, char** argv) {
+  enum OPTIONS { OPT_SERVE, OPT_INPUT, OPT_OUTPUT, OPT_FORMAT };
+  static struct option long_options[] = {
+      {"serve", required_argument, NULL, OPT_SERVE},
+      {"input_file", required_argument, NULL, OPT_INPUT},
+      {"output_folder", required_argument, NULL, OPT_OUTPUT},
+      {"format", required_argument, NULL, OPT_FORMAT},
+      {0, 0, 0, 0}};
+
+  const char* socket_path = NULL;
+  const char* inputs[MAX_INPUTS];
+  int num_inputs = 0;
+  char folder[MAX_PATH_LENGTH] = {0};
+  OutputFormat format = FORMAT_HEX;
+  int opt;
+  int option_index = 0;
+
+  while ((opt = getopt_long_only(argc, argv, "", long_options,
+                                 &option_index)) != -1) {
+    switch (opt) {
+      case OPT_SERVE:
+        socket_path = optarg;
+        break;
+      case OPT_INPUT:
+        if (num_inputs == MAX_INPUTS) {
+          printf("At most %d input files.\n", MAX_INPUTS);
+          return 1;
+        }
+        inputs[num_inputs++] = optarg;
+        break;
+      case OPT_OUTPUT:
+        if (optarg[strlen(optarg) - 1] == '/') {
+          snprintf(folder, sizeof(folder), "%s", optarg);
+        } else {
+          snprintf(folder, sizeof(folder), "%s/", optarg);
+        }
+        break;
+      case OPT_FORMAT:
+        if (strcmp(optarg, "hex") == 0) {
+          format = FORMAT_HEX;
+        } else if (strcmp(optarg, "bin") == 0) {
+          format = FORMAT_BIN;
+        } else if (strcmp(optarg, "elf") == 0) {
+          format = FORMAT_ELF;
+        } else {
+          printf("--format expects hex, bin or elf.\n");
+          return 1;
+        }
+        break;
+      default:
+        printf("Usage: %s --serve SOCKET --input_file FILE... "
+               "--output_folder DIR [--format hex|bin|elf]\n",
+               argv[0]);
+        return 1;
+    }
+  }
+  if (!socket_path || num_inputs == 0 || strlen(folder) == 0) {
+    printf("Please provide the server socket, input files and output "
+           "folder.\n");
+    return 1;
+  }
+
+  int fd = protocol_connect(socket_path);
+  if (fd < 0) {
+    printf("Cannot connect to %s.\n", socket_path);
+    return 1;
+  }
+  Response resp = {0};
+  int err = 0;
+  for (int i = 0; i < num_inputs; i++) {
+    size_t len;
+    char* src = read_source(inputs[i], &len);
+    if (!src || len > PROTOCOL_MAX_SOURCE) {
+      printf("Cannot read %s.\n", inputs[i]);
+      free(src);
+      err = 1;
+      continue;
+    }
+    int sent = protocol_send_request(fd, format, src, (uint32_t)len);
+    free(src);
+    if (sent != 0 || protocol_recv_response(fd, &resp) != 0) {
+      printf("Lost the connection to %s.\n", socket_path);
+      err = 1;
+      break;
+    }
+    if (write_result(inputs[i], folder, "out", resp.out,
+                     resp.header.out_len) != 0 ||
+        write_result(inputs[i], folder, "log", resp.log,
+                     resp.header.log_len) != 0 ||
+        resp.header.status != ASSEMBLE_OK) {
+      err = 1;
+    }
+  }
+  protocol_response_release(&resp);
+  close(fd);
+  return err;
+}
@@ -4,32 +4,70 @@
    Updated by Chibin Zhang and Zhe Ye in March 2021.
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "assembler.h"
 
 #include <getopt.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
+#include "src/backpatch.h"
 #include "src/block.h"
+#include "src/compress.h"
+#include "src/cache.h"
+#include "src/disasm.h"
+#include "src/ir.h"
+#include "src/object.h"
+#include "src/parallel.h"
+#include "src/peephole.h"
+#include "src/protocol.h"
+#include "src/relax.h"
+#include "src/scan.h"
+#include "src/schedule.h"
+#include "src/source.h"
+#include "src/stats.h"
 #include "src/tables.h"
 #include "src/translate.h"
 #include "src/translate_utils.h"
 #include "src/utils.h"
+#include "src/writer.h"
 
 #define MAX_ARGS 3
 #define BUF_SIZE 1024
 #define MAX_PATH_LENGTH 512
+/* Rough number of source bytes per instruction and per label, used to presize
+   the IrProgram and the SymbolTable from the input size. Over-estimating is
+   cheap since the untouched tail of a large allocation is never paged in. */
+#define SOURCE_BYTES_PER_INSTR 16
+#define SOURCE_BYTES_PER_LABEL 256
 const char* IGNORE_CHARS = " \f\n\r\t\v,()";
 
+/* Statistics of the assembly running on this thread, if --stats is on. */
+static _Thread_local AssembleStats* active_stats = NULL;
+
 /*******************************
  * Helper Functions
  *******************************/
 
+/* Counts a diagnostic for --stats. */
+static void count_error(void) {
+  if (active_stats) {
+    active_stats->errors++;
+  }
+}
+
 /* you should not be calling this function yourself. */
 static void raise_label_error(uint32_t input_line, const char* label) {
+  count_error();
   write_to_log("Error - invalid label at line %d: %s\n", input_line, label);
 }
 
@@ -43,6 +81,7 @@ static void raise_label_error(uint32_t input_line, const char* label) {
  */
 static void raise_extra_argument_error(uint32_t input_line,
                                        const char* extra_arg) {
+  count_error();
   write_to_log("Error - extra argument at line %d: %s\n", input_line,
                extra_arg);
 }
@@ -55,10 +94,20 @@ static void raise_extra_argument_error(uint32_t input_line,
  */
 static void raise_instruction_error(uint32_t input_line, const char* name,
                                     char** args, int num_args) {
+  count_error();
   write_to_log("Error - invalid instruction at line %d: ", input_line);
   log_inst(name, args, num_args);
 }
 
+/* Reports instruction INDEX of PROG, which failed to encode in pass two,
+   with the line and the text pass one kept for it. */
+static void raise_ir_error(const IrProgram* prog, uint32_t index) {
+  const IrSource* source = &prog->sources[index];
+  count_error();
+  write_to_log("Error - invalid instruction at line %d: %s\n", source->line,
+               source->text);
+}
+
 /* Truncates the string at the first occurrence of the '#' character. */
 static void skip_comments(char* str) {
   char* comment_start = strchr(str, '#');
@@ -88,12 +137,110 @@ static int add_if_label(uint32_t input_line, char* str, uint32_t byte_offset,
                         SymbolTable* symtbl) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-
+  size_t len = strlen(str);
+  if (len == 0 || str[len - 1] != ':') {
+    return 0;
+  }
+  str[len - 1] = '\0';
+  if (!is_valid_label(str)) {
+    raise_label_error(input_line, str);
+    return -1;
+  }
+  if (add_to_table(symtbl, str, byte_offset) != 0) {
+    count_error();
+    return -1;
+  }
+  return 1;
   /* === end === */
   return 0;
 }
 
+/* Most tokens a line can usefully have: a label, the instruction name,
+   MAX_ARGS arguments and the first extra argument (for the error message). */
+#define MAX_LINE_TOKENS (MAX_ARGS + 3)
+
+/* Handles the tokens of one source line: a leading label, then the
+   instruction name and its arguments, which are passed to write_pass_one().
+   NUM_TOKENS may be capped at MAX_LINE_TOKENS; later tokens never matter.
+
+   If PROG is not NULL, the line's instructions are decoded into it, so the
+   program is never held as strings; BLK is only used for the expansion of
+   a pseudo-instruction and is emptied again. Otherwise the caller takes
+   the instructions from BLK.
+
+   OFFSET is the byte offset of the next instruction and is advanced by the
+   size of whatever gets written. Returns -1 if an error was reported, 0
+   otherwise.
+ */
+static int parse_tokens(char** tokens, int num_tokens, uint32_t input_line,
+                        uint32_t* offset, Block* blk, IrProgram* prog,
+                        SymbolTable* table) {
+  int error = 0;
+  int next = 0;
+
+  blk->line_number = input_line;
+  if (num_tokens == 0) {
+    return 0;
+  }
+
+  int label_status = add_if_label(input_line, tokens[0], *offset, table);
+  if (label_status == -1) {
+    error = 1;
+  }
+  if (label_status != 0) {
+    next++;
+    if (next == num_tokens) {
+      return error ? -1 : 0;
+    }
+  }
+
+  const char* name = tokens[next++];
+  char** args = &tokens[next];
+  int num_args = num_tokens - next;
+  if (num_args > MAX_ARGS) {
+    raise_extra_argument_error(input_line, args[MAX_ARGS]);
+    return -1;
+  }
+
+  if (prog && !find_pseudo_handler(name)) {
+    /* write_pass_one() would copy a plain instruction into BLK as it is;
+       decode it from the tokens instead. */
+    ir_append(prog, input_line, name, args, (uint32_t)num_args);
+    *offset += 4;
+    return error ? -1 : 0;
+  }
+  unsigned written = write_pass_one(blk, name, args, num_args);
+  if (written == 0) {
+    raise_instruction_error(input_line, name, args, num_args);
+    error = 1;
+  }
+  *offset += written * 4;
+  if (prog && blk->len) {
+    ir_build(prog, blk);
+    block_clear(blk);
+  }
+  return error ? -1 : 0;
+}
+
+/* Strips the comment from LINE, tokenizes it in place with strtok_r() (so
+   that several files can be parsed concurrently) and hands the tokens to
+   parse_tokens(). */
+static int parse_line(char* line, uint32_t input_line, uint32_t* offset,
+                      Block* blk, IrProgram* prog, SymbolTable* table) {
+  char* tokens[MAX_LINE_TOKENS];
+  int num_tokens = 0;
+
+  skip_comments(line);
+  char* save;
+  char* token = strtok_r(line, IGNORE_CHARS, &save);
+  while (token && num_tokens < MAX_LINE_TOKENS) {
+    tokens[num_tokens++] = token;
+    token = strtok_r(NULL, IGNORE_CHARS, &save);
+  }
+  return parse_tokens(tokens, num_tokens, input_line, offset, blk, prog,
+                      table);
+}
+
 /*******************************
  * Implement the Following
  *******************************/
@@ -130,13 +277,12 @@ static int add_if_label(uint32_t input_line, char* str, uint32_t byte_offset,
    exit, but process the entire file and return -1. If no errors were
    encountered, it should return 0.
  */
-int pass_one(FILE* input, Block* blk, SymbolTable* table) {
+int pass_one(FILE* input, Block* blk, IrProgram* prog, SymbolTable* table) {
   /* A buffer for line parsing. */
   char buf[BUF_SIZE];
 
-  /* Variables for argument parsing. */
-  char* args[MAX_ARGS];
   uint32_t offset = 0;
+  uint32_t input_line = 0;
   int error = 0;
   /* For each line, there are some hints of what you should do:
       1. Skip all comments
@@ -149,18 +295,178 @@ int pass_one(FILE* input, Block* blk, SymbolTable* table) {
   while (fgets(buf, BUF_SIZE, input)) {
     /* IMPLEMENT ME */
     /* === start === */
-    
-
+    input_line++;
+    if (parse_line(buf, input_line, &offset, blk, prog, table) != 0) {
+      error = 1;
+    }
     /* === end === */
   }
-  return 0;
+  blk->line_number = input_line + 1;
+  return error ? -1 : 0;
+}
+
+/* Pass one over SCAN, the tokens of the part of SRC that starts at byte
+   BASE, after FIRST_LINE lines. OFFSET is the byte offset of the next
+   instruction and is advanced.
+
+   The mapping is read-only, so each line's tokens are copied into SRC's
+   scratch line and NUL-terminated there, much as fgets() copies a line for
+   pass_one(). Terminating them in a writable private mapping instead costs
+   a copy-on-write fault and a fresh page for every page of the file. */
+static int parse_scanned(SourceMap* src, size_t base, uint32_t first_line,
+                         const TokenList* scan, uint32_t* offset, Block* blk,
+                         IrProgram* prog, SymbolTable* table) {
+  int error = 0;
+  char* tokens[MAX_LINE_TOKENS];
+
+  for (size_t i = 0; i < scan->len;) {
+    uint32_t line = scan->tokens[i].line;
+    size_t end = i;
+    size_t need = 0;
+    for (; end < scan->len && scan->tokens[end].line == line; end++) {
+      need += scan->tokens[end].len + 1;
+    }
+    int num_tokens = 0;
+    char* pos = source_line(src, need);
+    for (; i < end && num_tokens < MAX_LINE_TOKENS; i++) {
+      const Token* token = &scan->tokens[i];
+      memcpy(pos, src->data + base + token->offset, token->len);
+      pos[token->len] = '\0';
+      tokens[num_tokens++] = pos;
+      pos += token->len + 1;
+    }
+    i = end;
+    if (parse_tokens(tokens, num_tokens, first_line + line, offset, blk, prog,
+                     table) != 0) {
+      error = 1;
+    }
+  }
+  return error ? -1 : 0;
+}
+
+/* Pass one over SCAN, the tokens of SRC. */
+static int pass_one_tokens(SourceMap* src, const TokenList* scan, Block* blk,
+                           IrProgram* prog, SymbolTable* table) {
+  uint32_t offset = 0;
+  int error = parse_scanned(src, 0, 0, scan, &offset, blk, prog, table);
+  blk->line_number = scan->num_lines + 1;
+  return error;
+}
+
+/* First pass over a memory-mapped source (see source.h). Behaves exactly like
+   pass_one(), but the whole mapping is split into tokens by scan_tokens()
+   in one vectorized pass instead of line by line, so there is no BUF_SIZE
+   limit on line length. SRC is only read.
+ */
+int pass_one_mapped(SourceMap* src, Block* blk, IrProgram* prog,
+                    SymbolTable* table) {
+  TokenList scan;
+  if (scan_tokens(src->data, src->len, &scan) != 0) {
+    block_allocation_failed();
+  }
+  stats_note_tokens(active_stats, &scan);
+  int error = pass_one_tokens(src, &scan, blk, prog, table);
+  free_token_list(&scan);
+  return error;
+}
+
+/* Single-pass assembly. Reads INPUT line by line like pass_one() and
+   encodes every instruction as soon as its line has been parsed; references
+   to labels further down are patched when the label is defined (see
+   backpatch.h). Only the current line is kept in a Block, so memory grows
+   with the number of labels and unresolved references instead of with the
+   size of the program. If INST_FILE is not NULL, each line's instructions
+   are appended to it as ir_write() would.
+
+   Produces the same output and the same log as pass_one() followed by
+   pass_two(): pass-one diagnostics are written as they are found, the
+   instructions that fail to encode are reported at the end in source order.
+
+   INPUT is read through a LineReader, so when it is a pipe, OUTPUT is
+   flushed whenever the writer on the other end falls behind.
+ */
+int pass_single(FILE* input, SymbolTable* table, OutputWriter* output,
+                FILE* inst_file) {
+  char buf[BUF_SIZE];
+  Block* line_blk = create_block();
+  IrProgram line_prog;
+  Backpatcher bp;
+  LineReader reader;
+
+  if (inst_file) {
+    ir_init(&line_prog, 0);
+  }
+  backpatch_init(&bp, output);
+  /* The reader uses the descriptor; bring its offset to the stream's
+     position (input_size() seeks the stream). */
+  fflush(input);
+  line_reader_init(&reader, fileno(input), output);
+  uint32_t offset = 0;
+  uint32_t input_line = 0;
+  int error = 0;
+  while (line_reader_gets(&reader, buf, BUF_SIZE)) {
+    input_line++;
+    uint32_t num_labels = table->len;
+    if (parse_line(buf, input_line, &offset, line_blk, NULL, table) != 0) {
+      error = 1;
+    }
+    for (uint32_t i = num_labels; i < table->len; i++) {
+      backpatch_define(&bp, table->entries[i].name, table->entries[i].addr);
+    }
+    for (uint32_t i = 0; i < line_blk->len; i++) {
+      backpatch_add(&bp, &line_blk->entries[i], table);
+    }
+    if (inst_file) {
+      ir_clear(&line_prog);
+      ir_build(&line_prog, line_blk);
+      ir_write(&line_prog, inst_file);
+    }
+    if (active_stats) {
+      active_stats->instructions += line_blk->len;
+    }
+    block_clear(line_blk);
+  }
+  if (active_stats) {
+    active_stats->lines = input_line;
+    stats_note_block(active_stats, line_blk);
+  }
+
+  if (backpatch_finish(&bp) != 0) {
+    error = 1;
+  }
+  for (uint32_t i = 0; i < bp.num_failures; i++) {
+    EncodeFailure* failure = &bp.failures[i];
+    raise_instruction_error(failure->line_number, failure->name,
+                            failure->args, failure->arg_num);
+  }
+  backpatch_release(&bp);
+  line_reader_release(&reader);
+  if (inst_file) {
+    ir_release(&line_prog);
+  }
+  free_block(line_blk);
+  return error ? -1 : 0;
+}
+
+/* Encodes the resolved PROG to OUTPUT. Instructions that fail to encode
+   are reported with their source text and skipped. Returns -1 if there
+   were any. */
+static int encode_program(IrProgram* prog, OutputWriter* output) {
+  int error = 0;
+  for (uint32_t i = 0; i < prog->len; ++i) {
+    if (ir_emit(prog, i, output) != 0) {
+      raise_ir_error(prog, i);
+      error = 1;
+    }
+  }
+  return error ? -1 : 0;
 }
 
 /* Second pass of the assembler.
    If an error is reached, DO NOT EXIT the function. Keep translating the rest
    of the document, and at the end, return -1. Return 0 if no errors were
    encountered. */
-int pass_two(Block* blk, SymbolTable* table, FILE* output) {
+int pass_two(IrProgram* prog, SymbolTable* table, OutputWriter* output) {
   if (output == NULL) {
     printf("wrong file opened.\n");
     return -1;
@@ -181,19 +487,294 @@ int pass_two(Block* blk, SymbolTable* table, FILE* output) {
      write the instruction.
    */
 
-  /* Variables for argument parsing. */
+  /* Pass one already decoded every instruction into PROG; only the labels
+     are left to look up. */
+  ir_resolve(prog, table);
+  return encode_program(prog, output);
+}
+
+/* Pass two over PROG on JOBS threads (see encode_parallel()). Produces the
+   same output and the same diagnostics, in the same order, as
+   pass_two(). */
+int pass_two_ir(IrProgram* prog, SymbolTable* table, OutputWriter* output,
+                int jobs) {
+  uint32_t* failed;
+  uint32_t num_failed;
+
+  if (output == NULL || table == NULL || jobs <= 1) {
+    return pass_two(prog, table, output);
+  }
+  ir_resolve(prog, table);
+  if (encode_parallel(prog, output, jobs, &failed, &num_failed) != 0) {
+    /* The workers could not be set up; nothing was written yet. */
+    return encode_program(prog, output);
+  }
+  for (uint32_t i = 0; i < num_failed; i++) {
+    raise_ir_error(prog, failed[i]);
+  }
+  free(failed);
+  return num_failed ? -1 : 0;
+}
+
+/*******************************
+ * Incremental Assembly
+ *******************************/
+
+/* A chunk of the source (see cache.h) in an incremental build. */
+typedef struct {
+  SourceChunk text;
+  /* Number of lines before the chunk. */
+  uint32_t first_line;
+  /* Address of the chunk's first instruction. */
+  uint32_t base;
+  /* The cached result, if the chunk is unchanged since the last build.
+     Otherwise the chunk went through pass one into the build's program, as
+     instructions [first_instr, end_instr), and added the symbols
+     [first_label, end_label). */
+  ChunkRecord* cached;
+  uint32_t first_instr;
+  uint32_t end_instr;
+  uint32_t first_label;
+  uint32_t end_label;
+  /* Pass one reported an error in the chunk. */
+  int error;
+  /* New record for a chunk that was assembled without errors. */
+  ChunkRecord* record;
+} BuildChunk;
+
+/* State shared by pass_one_incremental() and pass_two_incremental(). */
+typedef struct {
+  ChunkCache cache;
+  BuildChunk* chunks;
+  uint32_t num_chunks;
+  /* Number of instructions in the program. */
+  uint32_t num_instrs;
+} IncrementalBuild;
+
+/* Pass one over the text of CHUNK alone. */
+static int pass_one_chunk(SourceMap* src, const BuildChunk* chunk,
+                          uint32_t* offset, Block* blk, IrProgram* prog,
+                          SymbolTable* table) {
+  TokenList scan;
+  if (scan_tokens(src->data + chunk->text.start, chunk->text.len, &scan) !=
+      0) {
+    block_allocation_failed();
+  }
+  int error = parse_scanned(src, chunk->text.start, chunk->first_line, &scan,
+                            offset, blk, prog, table);
+  free_token_list(&scan);
+  return error;
+}
+
+/* Encodes instructions [FIRST, END) of the resolved PROG at addresses from
+   BASE on, like encode_program(). If RECORD is not NULL, it receives the
+   words and the label uses. Returns -1 if any instruction failed. */
+static int encode_chunk(IrProgram* prog, uint32_t first, uint32_t end,
+                        uint32_t base, OutputWriter* output,
+                        ChunkRecord* record) {
   int error = 0;
-  /* Process each instruction */
-  for (uint32_t i = 0; i < blk->len; ++i) {
-    Instr* inst = &blk->entries[i];
-    /* IMPLEMENT ME */
-    /* === start === */
-    
-    
-    /* === end === */
+  uint32_t num_uses = 0;
+  uint32_t names_len = record ? record->names_len : 0;
+  for (uint32_t i = first; i < end; i++) {
+    IrInstr* ir = &prog->code[i];
+    uint32_t addr = base + (i - first) * 4;
+    int64_t label_addr = 0;
+    uint32_t word;
+    if (ir->op != IR_INVALID && ir->sym != IR_NO_SYMBOL) {
+      label_addr = prog->ref_addrs[ir->sym];
+    }
+    if (ir->op == IR_INVALID ||
+        encode_inst(ir, addr, label_addr, &word) != 0) {
+      raise_ir_error(prog, i);
+      error = 1;
+      continue;
+    }
+    write_inst(output, word);
+    if (!record) {
+      continue;
+    }
+    record->words[i - first] = word;
+    if (ir->sym != IR_NO_SYMBOL) {
+      ChunkUse* use = &record->uses[num_uses++];
+      const char* name = prog->refs[ir->sym];
+      use->index = i - first;
+      use->name = names_len;
+      use->addr = addr;
+      use->label_addr = label_addr;
+      use->ir = *ir;
+      use->ir.sym = 0;
+      strcpy(record->names + names_len, name);
+      names_len += (uint32_t)strlen(name) + 1;
+    }
+  }
+  if (record) {
+    record->names_len = names_len;
   }
+  return error ? -1 : 0;
+}
 
-  return 0;
+/* Returns a record for the parsed CHUNK with its label definitions filled
+   in, for encode_chunk() to complete. */
+static ChunkRecord* start_chunk_record(const BuildChunk* chunk,
+                                       const IrProgram* prog,
+                                       SymbolTable* table) {
+  uint32_t num_uses = 0;
+  uint32_t names_len = 0;
+  for (uint32_t i = chunk->first_label; i < chunk->end_label; i++) {
+    names_len += (uint32_t)strlen(table->entries[i].name) + 1;
+  }
+  uint32_t defs_len = names_len;
+  for (uint32_t i = chunk->first_instr; i < chunk->end_instr; i++) {
+    const IrInstr* ir = &prog->code[i];
+    if (ir->op != IR_INVALID && ir->sym != IR_NO_SYMBOL) {
+      num_uses++;
+      names_len += (uint32_t)strlen(prog->refs[ir->sym]) + 1;
+    }
+  }
+  ChunkRecord* record = create_chunk_record(
+      &chunk->text, chunk->end_instr - chunk->first_instr,
+      chunk->end_label - chunk->first_label, num_uses, names_len);
+  uint32_t pos = 0;
+  for (uint32_t i = chunk->first_label; i < chunk->end_label; i++) {
+    Symbol* sym = &table->entries[i];
+    ChunkDef* def = &record->defs[i - chunk->first_label];
+    def->name = pos;
+    def->offset = sym->addr - chunk->base;
+    strcpy(record->names + pos, sym->name);
+    pos += (uint32_t)strlen(sym->name) + 1;
+  }
+  /* encode_chunk() appends the names of the uses. */
+  record->names_len = defs_len;
+  return record;
+}
+
+/* Encodes CHUNK, whose cached words no longer encode, from its text, so
+   that the failures are reported as a clean build would. */
+static int encode_reparsed(SourceMap* src, const BuildChunk* chunk,
+                           SymbolTable* table, OutputWriter* output) {
+  Block* blk = create_block();
+  IrProgram prog;
+  ir_init(&prog, 0);
+  /* Labels are already in TABLE; a table that allows duplicates keeps them
+     from being reported twice. */
+  SymbolTable* labels = create_table(SYMBOLTBL_NON_UNIQUE);
+  uint32_t offset = chunk->base;
+  pass_one_chunk(src, chunk, &offset, blk, &prog, labels);
+  ir_resolve(&prog, table);
+  int error = encode_chunk(&prog, 0, prog.len, chunk->base, output, NULL);
+  ir_release(&prog);
+  free_table(labels);
+  free_block(blk);
+  return error;
+}
+
+/* Incremental first pass over SRC with the records in BUILD->cache. The
+   source is split into chunks; a chunk with a record only has its label
+   definitions added to TABLE, the others go through pass one into PROG.
+   Reports the same diagnostics as pass_one_mapped(). */
+static int pass_one_incremental(IncrementalBuild* build, SourceMap* src,
+                                Block* blk, IrProgram* prog,
+                                SymbolTable* table) {
+  SourceChunk* text;
+  build->num_chunks = split_chunks(src->data, src->len, &text);
+  build->chunks = calloc(build->num_chunks + 1, sizeof(BuildChunk));
+  if (!build->chunks) {
+    allocation_failed();
+  }
+
+  uint32_t offset = 0;
+  uint32_t line = 0;
+  int error = 0;
+  for (uint32_t i = 0; i < build->num_chunks; i++) {
+    BuildChunk* chunk = &build->chunks[i];
+    chunk->text = text[i];
+    chunk->first_line = line;
+    chunk->base = offset;
+    chunk->cached = cache_find(&build->cache, &text[i]);
+    line += text[i].num_lines;
+    if (chunk->cached) {
+      ChunkRecord* cached = chunk->cached;
+      for (uint32_t j = 0; j < cached->num_defs; j++) {
+        if (add_to_table(table, cached->names + cached->defs[j].name,
+                         chunk->base + cached->defs[j].offset) != 0) {
+          count_error();
+          error = 1;
+        }
+      }
+      offset += cached->num_words * 4;
+      continue;
+    }
+    chunk->first_instr = prog->len;
+    chunk->first_label = table->len;
+    if (pass_one_chunk(src, chunk, &offset, blk, prog, table) != 0) {
+      chunk->error = 1;
+      error = 1;
+    }
+    chunk->end_instr = prog->len;
+    chunk->end_label = table->len;
+  }
+  free(text);
+  build->num_instrs = offset / 4;
+  blk->line_number = line + 1;
+  return error ? -1 : 0;
+}
+
+/* Incremental second pass: cached chunks are relocated (see
+   relocate_chunk_record()), the parsed ones in PROG are encoded and get new
+   records. Produces the same output and diagnostics as pass_two(). */
+static int pass_two_incremental(IncrementalBuild* build, SourceMap* src,
+                                IrProgram* prog, SymbolTable* table,
+                                OutputWriter* output) {
+  ir_resolve(prog, table);
+  int error = 0;
+  for (uint32_t i = 0; i < build->num_chunks; i++) {
+    BuildChunk* chunk = &build->chunks[i];
+    if (chunk->cached) {
+      if (relocate_chunk_record(chunk->cached, chunk->base, table) != 0) {
+        encode_reparsed(src, chunk, table, output);
+        error = 1;
+        continue;
+      }
+      for (uint32_t j = 0; j < chunk->cached->num_words; j++) {
+        write_inst(output, chunk->cached->words[j]);
+      }
+      continue;
+    }
+    ChunkRecord* record =
+        chunk->error ? NULL : start_chunk_record(chunk, prog, table);
+    if (encode_chunk(prog, chunk->first_instr, chunk->end_instr, chunk->base,
+                     output, record) != 0) {
+      free(record);
+      record = NULL;
+      error = 1;
+    }
+    chunk->record = record;
+  }
+  return error ? -1 : 0;
+}
+
+/* Writes the records of BUILD's chunks to the cache file at PATH and frees
+   the build. */
+static void finish_incremental(IncrementalBuild* build, const char* path) {
+  ChunkRecord** records =
+      malloc((build->num_chunks + 1) * sizeof(ChunkRecord*));
+  if (records) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < build->num_chunks; i++) {
+      BuildChunk* chunk = &build->chunks[i];
+      if (chunk->cached || chunk->record) {
+        records[count++] = chunk->cached ? chunk->cached : chunk->record;
+      }
+    }
+    /* The cache only saves time; a build without it is still correct. */
+    cache_save(path, records, count);
+    free(records);
+  }
+  for (uint32_t i = 0; i < build->num_chunks; i++) {
+    free(build->chunks[i].record);
+  }
+  free(build->chunks);
+  cache_release(&build->cache);
 }
 
 static void close_files(int count, ...) {
@@ -210,6 +791,17 @@ static void close_files(int count, ...) {
   va_end(args);
 }
 
+/* Returns the size of INPUT in bytes and rewinds it, or 0 if the size cannot
+   be determined (e.g. INPUT is not seekable). */
+static long input_size(FILE* input) {
+  if (fseek(input, 0, SEEK_END) != 0) {
+    return 0;
+  }
+  long size = ftell(input);
+  rewind(input);
+  return size > 0 ? size : 0;
+}
+
 /* Output folder is assured to end with "/" */
 void ResolvePath(const char* input_filename, const char* output_folder,
                  char* output_filename, char* log_filename, char* tbl_filename,
@@ -257,65 +849,941 @@ void ResolvePath(const char* input_filename, const char* output_folder,
   }
 }
 
+void default_assemble_options(AssembleOptions* opts) {
+  opts->test = 0;
+  opts->jobs = 1;
+  opts->format = FORMAT_HEX;
+  opts->single_pass = 0;
+  opts->stats = STATS_NONE;
+  opts->incremental = 0;
+  opts->to_stdout = 0;
+  opts->optimize = 0;
+  opts->schedule = NULL;
+  opts->relax = 0;
+  opts->compress = 0;
+}
+
+/* Runs the peephole pass over PROG and logs how many instructions it
+   removed. */
+static uint32_t optimize_program(IrProgram* prog, SymbolTable* tbl) {
+  uint32_t eliminated = peephole_program(prog, tbl);
+  write_to_log("Peephole optimization eliminated %u instructions.\n",
+               eliminated);
+  return eliminated;
+}
+
+/* Reorders PROG for the pipeline model named CORE and logs the stall cycles
+   saved. Returns -1 if there is no such model. */
+static int schedule_for_core(IrProgram* prog, SymbolTable* tbl,
+                             const char* core) {
+  const PipelineModel* model = find_pipeline_model(core);
+  if (!model) {
+    count_error();
+    write_to_log("Error: unknown pipeline model %s\n", core);
+    return -1;
+  }
+  uint32_t saved = schedule_program(prog, tbl, model);
+  write_to_log("Scheduling for %s saved %u stall cycles.\n", model->name,
+               saved);
+  return 0;
+}
+
 /* Runs the two-pass assembler. Most of the actual work is done in pass_one()
    and pass_two().
  */
 int assemble(const char* in, const char* out, int test) {
+  AssembleOptions opts;
+  default_assemble_options(&opts);
+  opts.test = test;
+  return assemble_with_options(in, out, &opts);
+}
+
+/* Like assemble(), with the behaviour selected by OPTS. */
+int assemble_with_options(const char* in, const char* out,
+                          const AssembleOptions* opts) {
+  int test = opts->test;
   FILE *input, *output, *tbl_file, *inst_file;
   char output_filename[MAX_PATH_LENGTH];
   char log_filename[MAX_PATH_LENGTH];
   char tbl_filename[MAX_PATH_LENGTH];
   char inst_filename[MAX_PATH_LENGTH];
   int err = 0;
+  /* "-" is standard input; the .tbl and .inst files of --test are then
+     named after "stdin". */
+  int from_stdin = strcmp(in, "-") == 0;
+  const char* name = from_stdin ? "stdin" : in;
 
   if (test) {
-    ResolvePath(in, out, output_filename, log_filename, tbl_filename,
+    ResolvePath(name, out, output_filename, log_filename, tbl_filename,
                 inst_filename);
   } else {
-    ResolvePath(in, out, output_filename, log_filename, NULL, NULL);
+    ResolvePath(name, out, output_filename, log_filename, NULL, NULL);
   }
-  set_log_file(log_filename);
+  /* Without a log file, diagnostics go to stderr. */
+  set_log_file(opts->to_stdout ? NULL : log_filename);
 
-  SymbolTable* tbl = create_table(SYMBOLTBL_UNIQUE_NAME);
-  Block* blk = create_block();
+  AssembleStats stats;
+  PhaseTimer timer;
+  if (opts->stats != STATS_NONE) {
+    stats_init(&stats);
+    active_stats = &stats;
+    count_pseudo_expansions(stats.pseudo_expansions);
+  }
+  stats_start(active_stats, &timer);
 
-  input = fopen(in, "r");
-  output = fopen(output_filename, "w");
+  input = from_stdin ? stdin : fopen(in, "r");
+  output = opts->to_stdout ? stdout : fopen(output_filename, "w");
 
+  /* Nothing has been written; report failure without ending the process,
+     since other files may be assembled after (or alongside) this one. */
   if (input == NULL || output == NULL) {
-    exit(1);
+    close_files(2, from_stdin ? NULL : input,
+                opts->to_stdout ? NULL : output);
+    set_log_file(NULL);
+    active_stats = NULL;
+    count_pseudo_expansions(NULL);
+    return 1;
   }
-  // what does pass_one return"
-  if (pass_one(input, blk, tbl) != 0) {
-    err = 1;
+
+  long size = input_size(input);
+  SymbolTable* tbl = create_table_with_capacity(
+      SYMBOLTBL_UNIQUE_NAME, (uint32_t)(size / SOURCE_BYTES_PER_LABEL));
+  tbl_file = NULL;
+  inst_file = NULL;
+  if (test) {
+    tbl_file = fopen(tbl_filename, "w");
+    inst_file = fopen(inst_filename, "w");
   }
-  if (pass_two(blk, tbl, output) != 0) {
+
+  /* Encoded instructions bypass stdio and go to the file descriptor in
+     large writes. An ELF header needs the size of .text, so in that case
+     the instructions are collected in memory first. */
+  OutputWriter writer, text;
+  OutputWriter* sink = &writer;
+  writer_init_fd(&writer, fileno(output));
+  if (active_stats) {
+    writer.io_time = &active_stats->phases[PHASE_WRITE];
+  }
+  if (opts->format == FORMAT_ELF) {
+    writer_init_memory(&text);
+    sink = &text;
+  }
+  sink->word_format = opts->format == FORMAT_HEX ? WORD_HEX : WORD_BIN;
+
+  /* A pipeline from standard input to standard output is assembled in a
+     single pass, so that output starts before the input ends. */
+  int single_pass = opts->single_pass || (from_stdin && opts->to_stdout);
+  /* Pass one parses each line into BLK and decodes it into PROG. */
+  Block* blk = NULL;
+  IrProgram prog;
+  SourceMap src;
+  int mapped = 0;
+  if (!single_pass) {
+    /* Regular files are mapped and tokenized as a whole; anything that
+       cannot be mapped (pipes, terminals) is read line by line. */
+    mapped = source_map(&src, input) == 0;
+  }
+  /* The cache sits next to the output, as NAME.cache. */
+  int incremental = opts->incremental && mapped && !test &&
+                    !opts->to_stdout && !opts->optimize && !opts->schedule &&
+                    !opts->relax && !opts->compress;
+  char cache_filename[MAX_PATH_LENGTH];
+  IncrementalBuild build;
+  if (incremental) {
+    snprintf(cache_filename, sizeof(cache_filename), "%.*s.cache",
+             (int)(strlen(output_filename) - 4), output_filename);
+    cache_load(&build.cache, cache_filename);
+  }
+  stats_stop(active_stats, PHASE_READ, &timer);
+
+  stats_start(active_stats, &timer);
+  if (single_pass) {
+    if (pass_single(input, tbl, sink, inst_file) != 0) {
+      err = 1;
+    }
+    stats_stop(active_stats, PHASE_PASS_ONE, &timer);
+  } else {
+    blk = create_block();
+    ir_init(&prog, (uint32_t)(size / SOURCE_BYTES_PER_INSTR));
+    if (incremental) {
+      if (pass_one_incremental(&build, &src, blk, &prog, tbl) != 0) {
+        err = 1;
+      }
+    } else if (mapped) {
+      if (pass_one_mapped(&src, blk, &prog, tbl) != 0) {
+        err = 1;
+      }
+    } else if (pass_one(input, blk, &prog, tbl) != 0) {
+      err = 1;
+    }
+    if (opts->optimize) {
+      uint32_t eliminated = optimize_program(&prog, tbl);
+      if (active_stats) {
+        stats.eliminated = eliminated;
+      }
+    }
+    if (opts->schedule &&
+        schedule_for_core(&prog, tbl, opts->schedule) != 0) {
+      err = 1;
+    }
+    if (opts->relax) {
+      relax_program(&prog, tbl);
+    }
+    stats_stop(active_stats, PHASE_PASS_ONE, &timer);
+
+    stats_start(active_stats, &timer);
+    if (incremental) {
+      if (pass_two_incremental(&build, &src, &prog, tbl, sink) != 0) {
+        err = 1;
+      }
+    } else {
+      if (opts->compress) {
+        compress_program(&prog, tbl);
+      }
+      if (pass_two_ir(&prog, tbl, sink, opts->jobs) != 0) {
+        err = 1;
+      }
+    }
+    stats_stop(active_stats, PHASE_PASS_TWO, &timer);
+  }
+
+  stats_start(active_stats, &timer);
+  if (opts->format == FORMAT_ELF) {
+    /* TEXT is in memory; it only fails when memory runs out. */
+    int failed = text.error ||
+                 write_elf(&writer, text.buf, text.len, tbl, opts->compress);
+    stats_note_writer(active_stats, &text);
+    if (writer_release(&text) != 0 || failed) {
+      count_error();
+      write_to_log("Error: allocation failed\n");
+      err = 1;
+    }
+  }
+  stats_note_writer(active_stats, &writer);
+  /* A full disk or a closed pipe only shows up here, when the last of the
+     output is flushed. */
+  if (writer_release(&writer) != 0) {
+    count_error();
+    write_to_log("Error: cannot write %s\n",
+                 opts->to_stdout ? "to stdout" : output_filename);
     err = 1;
   }
+  if (incremental) {
+    finish_incremental(&build, cache_filename);
+  }
+  stats_stop(active_stats, PHASE_WRITE, &timer);
   if (test) {
-    tbl_file = fopen(tbl_filename, "w");
-    inst_file = fopen(inst_filename, "w");
+    stats_start(active_stats, &timer);
     write_table(tbl, tbl_file);
-    write_block(blk, inst_file);
+    if (blk) {
+      ir_write(&prog, inst_file);
+    }
     close_files(2, tbl_file, inst_file);
+    stats_stop(active_stats, PHASE_DUMP, &timer);
+  }
+  if (active_stats) {
+    if (blk) {
+      stats.lines = blk->line_number - 1;
+      stats.instructions = incremental ? build.num_instrs : prog.len;
+      stats_note_ir(active_stats, &prog);
+    }
+    stats.labels = tbl->len;
+    stats_note_block(active_stats, blk);
+    stats_note_table(active_stats, tbl);
+    active_stats = NULL;
+    count_pseudo_expansions(NULL);
+    write_stats(stderr, &stats, name, opts->stats == STATS_JSON);
   }
   if (err) {
     write_to_log("One or more errors encountered during assembly operation.\n");
   } else {
     write_to_log("Assembly operation completed successfully!\n");
   }
+  /* LOG_FILENAME goes out of scope; leave this thread's logger unset. */
+  close_log();
+  set_log_file(NULL);
 
   free_table(tbl);
+  if (blk) {
+    ir_release(&prog);
+  }
   free_block(blk);
+  if (mapped) {
+    source_unmap(&src);
+  }
+
+  /* The standard streams stay open for other files of a batch. */
+  close_files(2, from_stdin ? NULL : input, opts->to_stdout ? NULL : output);
+  return err;
+}
+
+/* Work queue shared by the threads of assemble_batch(). */
+typedef struct {
+  const char* const* inputs;
+  int count;
+  const char* out;
+  AssembleOptions opts;
+
+  pthread_mutex_t lock;
+  /* Index of the next input to take, and whether any job failed. */
+  int next;
+  int err;
+} BatchQueue;
+
+static void* batch_worker(void* arg) {
+  BatchQueue* queue = arg;
+  for (;;) {
+    pthread_mutex_lock(&queue->lock);
+    int i = queue->next++;
+    pthread_mutex_unlock(&queue->lock);
+    if (i >= queue->count) {
+      return NULL;
+    }
+    if (assemble_with_options(queue->inputs[i], queue->out, &queue->opts) !=
+        0) {
+      pthread_mutex_lock(&queue->lock);
+      queue->err = 1;
+      pthread_mutex_unlock(&queue->lock);
+    }
+  }
+}
 
-  close_files(2, input, output);
+typedef struct {
+  char* path;
+  int input;
+} OutputPath;
+
+static int compare_output_paths(const void* a, const void* b) {
+  const OutputPath* x = a;
+  const OutputPath* y = b;
+  int cmp = strcmp(x->path, y->path);
+  return cmp ? cmp : x->input - y->input;
+}
+
+/* Returns -1, after reporting them, if two of the COUNT files in INPUTS
+   would be assembled into the same files in OUT (the same name in two
+   folders), which concurrent jobs would overwrite. */
+static int check_output_paths(const char* const* inputs, int count,
+                              const char* out) {
+  OutputPath* paths = malloc((size_t)count * sizeof(OutputPath));
+  if (!paths) {
+    allocation_failed();
+  }
+  char output_filename[MAX_PATH_LENGTH];
+  char log_filename[MAX_PATH_LENGTH];
+  for (int i = 0; i < count; i++) {
+    const char* name = strcmp(inputs[i], "-") == 0 ? "stdin" : inputs[i];
+    ResolvePath(name, out, output_filename, log_filename, NULL, NULL);
+    paths[i].path = strdup(output_filename);
+    paths[i].input = i;
+    if (!paths[i].path) {
+      allocation_failed();
+    }
+  }
+  qsort(paths, (size_t)count, sizeof(OutputPath), compare_output_paths);
+  int err = 0;
+  for (int i = 1; i < count && !err; i++) {
+    if (strcmp(paths[i - 1].path, paths[i].path) == 0) {
+      fprintf(stderr, "%s and %s would both be assembled into %s.\n",
+              inputs[paths[i - 1].input], inputs[paths[i].input],
+              paths[i].path);
+      err = -1;
+    }
+  }
+  for (int i = 0; i < count; i++) {
+    free(paths[i].path);
+  }
+  free(paths);
   return err;
 }
 
+/* Assembles each of the COUNT files in INPUTS into OUT as
+   assemble_with_options() would, on up to OPTS->jobs threads. Every job
+   runs its pass two sequentially, so each file's outputs are identical to a
+   standalone run. Returns 1 if any job failed, or without assembling
+   anything if two inputs have the same output files, 0 otherwise. */
+int assemble_batch(const char* const* inputs, int count, const char* out,
+                   const AssembleOptions* opts) {
+  if (check_output_paths(inputs, count, out) != 0) {
+    return 1;
+  }
+  BatchQueue queue;
+  queue.inputs = inputs;
+  queue.count = count;
+  queue.out = out;
+  queue.opts = *opts;
+  queue.opts.jobs = 1;
+  queue.next = 0;
+  queue.err = 0;
+  pthread_mutex_init(&queue.lock, NULL);
+
+  int num_threads = opts->jobs < count ? opts->jobs : count;
+  pthread_t threads[MAX_JOBS];
+  int started = 0;
+  /* The calling thread is one of the workers. */
+  for (; started < num_threads - 1; started++) {
+    if (pthread_create(&threads[started], NULL, batch_worker, &queue) != 0) {
+      break;
+    }
+  }
+  batch_worker(&queue);
+  for (int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&queue.lock);
+  return queue.err;
+}
+
+/* Everything assemble_buffer() allocates. It is kept on the heap rather
+   than in assemble_buffer()'s frame so that it can still be released after
+   an allocation failure longjmp()s back there, and it is kept between calls
+   so that the table, block and buffers only grow once. */
+struct AssembleContext {
+  SourceMap src;
+  TokenList scan;
+  /* Created on first use, and again after an allocation failure. */
+  SymbolTable* tbl;
+  /* The line pass one is parsing; the program goes to PROG. */
+  Block* blk;
+  IrProgram prog;
+  /* The encoded instructions; for FORMAT_ELF, TEXT holds .text and OUT the
+     whole file. */
+  OutputWriter out;
+  OutputWriter text;
+  OutputWriter log;
+};
+
+AssembleContext* create_assemble_context(void) {
+  AssembleContext* ctx = calloc(1, sizeof(AssembleContext));
+  if (!ctx) {
+    return NULL;
+  }
+  writer_init_memory(&ctx->out);
+  writer_init_memory(&ctx->text);
+  writer_init_memory(&ctx->log);
+  return ctx;
+}
+
+/* Frees what the last run left behind and releases the table and the block
+   as well if ALL is set (after an allocation failure they may be in any
+   state). The writers keep their buffers either way. */
+static void reset_assemble_context(AssembleContext* ctx, int all) {
+  free_token_list(&ctx->scan);
+  source_unmap(&ctx->src);
+  if (all) {
+    ir_release(&ctx->prog);
+    free_block(ctx->blk);
+    free_table(ctx->tbl);
+    ctx->blk = NULL;
+    ctx->tbl = NULL;
+  }
+}
+
+void free_assemble_context(AssembleContext* ctx) {
+  if (!ctx) {
+    return;
+  }
+  reset_assemble_context(ctx, 1);
+  writer_release(&ctx->out);
+  writer_release(&ctx->text);
+  writer_release(&ctx->log);
+  free(ctx);
+}
+
+/* The body of assemble_buffer(): assemble() on a copy of SRC, with the
+   output and the log going to CTX's memory writers. */
+static int run_assemble_context(AssembleContext* ctx, const char* src,
+                                size_t len, const AssembleOptions* opts) {
+  int err = 0;
+
+  /* Pass one only reads the source, so the caller's bytes are used as
+     they are. */
+  source_view(&ctx->src, src, len);
+  if (ctx->tbl) {
+    clear_table(ctx->tbl);
+    block_clear(ctx->blk);
+    ctx->blk->line_number = 1;
+    ir_clear(&ctx->prog);
+  } else {
+    ctx->tbl = create_table_with_capacity(
+        SYMBOLTBL_UNIQUE_NAME, (uint32_t)(len / SOURCE_BYTES_PER_LABEL));
+    ctx->blk = create_block();
+    ir_init(&ctx->prog, (uint32_t)(len / SOURCE_BYTES_PER_INSTR));
+  }
+  if (scan_tokens(ctx->src.data, ctx->src.len, &ctx->scan) != 0) {
+    block_allocation_failed();
+  }
+  if (pass_one_tokens(&ctx->src, &ctx->scan, ctx->blk, &ctx->prog,
+                      ctx->tbl) != 0) {
+    err = 1;
+  }
+  free_token_list(&ctx->scan);
+  if (opts->optimize) {
+    optimize_program(&ctx->prog, ctx->tbl);
+  }
+  if (opts->schedule &&
+      schedule_for_core(&ctx->prog, ctx->tbl, opts->schedule) != 0) {
+    err = 1;
+  }
+  if (opts->relax) {
+    relax_program(&ctx->prog, ctx->tbl);
+  }
+
+  OutputWriter* sink = opts->format == FORMAT_ELF ? &ctx->text : &ctx->out;
+  sink->word_format = opts->format == FORMAT_HEX ? WORD_HEX : WORD_BIN;
+  if (opts->compress) {
+    compress_program(&ctx->prog, ctx->tbl);
+  }
+  if (pass_two_ir(&ctx->prog, ctx->tbl, sink, opts->jobs) != 0) {
+    err = 1;
+  }
+  if (opts->format == FORMAT_ELF &&
+      (ctx->text.error ||
+       write_elf(&ctx->out, ctx->text.buf, ctx->text.len, ctx->tbl,
+                 opts->compress) != 0)) {
+    allocation_failed();
+  }
+  if (ctx->out.error) {
+    allocation_failed();
+  }
+
+  if (err) {
+    write_to_log("One or more errors encountered during assembly operation.\n");
+  } else {
+    write_to_log("Assembly operation completed successfully!\n");
+  }
+  return err ? ASSEMBLE_ERR_SOURCE : ASSEMBLE_OK;
+}
+
+/* Copies the LEN bytes at DATA to DST, or as many as fit in CAP. */
+static void copy_out(char* dst, size_t cap, const char* data, size_t len) {
+  if (len > cap) {
+    len = cap;
+  }
+  if (len > 0) {
+    memcpy(dst, data, len);
+  }
+}
+
+/* Assembles SRC entirely in memory (see assembler.h). Allocation failures
+   anywhere in the passes longjmp() back here instead of ending the process,
+   and everything allocated so far is released. */
+int assemble_buffer_with_context(AssembleContext* ctx, const char* src,
+                                 size_t len, const AssembleOptions* opts,
+                                 AssembleBuffers* bufs) {
+  AssembleOptions defaults;
+  if (!ctx || !bufs || (!src && len > 0) ||
+      (!bufs->out && bufs->out_cap > 0) || (!bufs->log && bufs->log_cap > 0) ||
+      (opts && opts->schedule && !find_pipeline_model(opts->schedule))) {
+    return ASSEMBLE_ERR_ARGS;
+  }
+  if (!opts) {
+    default_assemble_options(&defaults);
+    opts = &defaults;
+  }
+  bufs->out_len = 0;
+  bufs->log_len = 0;
+  writer_reset(&ctx->out);
+  writer_reset(&ctx->text);
+  writer_reset(&ctx->log);
+
+  jmp_buf env;
+  jmp_buf* prev_recovery = set_allocation_recovery(&env);
+  OutputWriter* prev_log = set_log_writer(&ctx->log);
+  int status;
+  if (setjmp(env) == 0) {
+    status = run_assemble_context(ctx, src ? src : "", len, opts);
+  } else {
+    status = ASSEMBLE_ERR_NOMEM;
+  }
+  set_log_writer(prev_log);
+  set_allocation_recovery(prev_recovery);
+
+  /* A message that could not be logged counts as running out of memory. */
+  if (ctx->log.error) {
+    status = ASSEMBLE_ERR_NOMEM;
+  }
+  if (status != ASSEMBLE_ERR_NOMEM) {
+    bufs->out_len = ctx->out.len;
+    copy_out(bufs->out, bufs->out_cap, ctx->out.buf, ctx->out.len);
+    if (ctx->out.len > bufs->out_cap) {
+      status = ASSEMBLE_ERR_SPACE;
+    }
+  }
+  bufs->log_len = ctx->log.len;
+  copy_out(bufs->log, bufs->log_cap, ctx->log.buf, ctx->log.len);
+  reset_assemble_context(ctx, status == ASSEMBLE_ERR_NOMEM);
+  return status;
+}
+
+int assemble_buffer(const char* src, size_t len, const AssembleOptions* opts,
+                    AssembleBuffers* bufs) {
+  AssembleContext* ctx = create_assemble_context();
+  if (!ctx) {
+    return ASSEMBLE_ERR_NOMEM;
+  }
+  int status = assemble_buffer_with_context(ctx, src, len, opts, bufs);
+  free_assemble_context(ctx);
+  return status;
+}
+
+/*******************************
+ * Disassembler
+ *******************************/
+
+/* Reads the labels of a .tbl file, as write_table() writes them, into
+   TABLE. Returns -1 if PATH cannot be read or has a malformed line. */
+static int read_symbols(const char* path, SymbolTable* table) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    write_to_log("Error: cannot open %s\n", path);
+    return -1;
+  }
+  char* line = NULL;
+  size_t cap = 0;
+  uint32_t line_number = 0;
+  int err = 0;
+  while (!err && getline(&line, &cap, file) > 0) {
+    line_number++;
+    line[strcspn(line, "\r\n")] = '\0';
+    char* tab = strchr(line, '\t');
+    char* end;
+    unsigned long addr = tab ? strtoul(line, &end, 10) : 0;
+    if (!tab || end != tab || tab[1] == '\0' || addr > UINT32_MAX) {
+      write_to_log("Error - invalid symbol at line %u of %s\n", line_number,
+                   path);
+      err = 1;
+      continue;
+    }
+    /* With --compress a label may sit on a 2-byte boundary, which
+       add_to_table() rejects; the address is set directly instead, as
+       compress_program() does. */
+    if (add_to_table(table, tab + 1, (uint32_t)addr & ~3u) != 0) {
+      err = 1;
+    } else {
+      table->entries[table->len - 1].addr = (uint32_t)addr;
+    }
+  }
+  free(line);
+  fclose(file);
+  return err ? -1 : 0;
+}
+
+/* Reads all of FILE into *DATA (heap) and *LEN. */
+static int read_stream(FILE* file, char** data, size_t* len) {
+  size_t cap = 64 * 1024;
+  *len = 0;
+  *data = malloc(cap);
+  while (*data) {
+    *len += fread(*data + *len, 1, cap - *len, file);
+    if (*len < cap) {
+      return ferror(file) ? -1 : 0;
+    }
+    cap *= 2;
+    char* grown = realloc(*data, cap);
+    if (!grown) {
+      free(*data);
+      *data = NULL;
+    } else {
+      *data = grown;
+    }
+  }
+  allocation_failed();
+  return -1;
+}
+
+int disassemble_file(const char* in, const char* symbols, OutputFormat format,
+                     FILE* output) {
+  if (format == FORMAT_ELF) {
+    write_to_log("Error: only hex and bin images can be disassembled\n");
+    return 1;
+  }
+  SymbolTable* table = NULL;
+  if (symbols) {
+    table = create_table(SYMBOLTBL_UNIQUE_NAME);
+    if (read_symbols(symbols, table) != 0) {
+      free_table(table);
+      return 1;
+    }
+  }
+  int from_stdin = strcmp(in, "-") == 0;
+  FILE* input = from_stdin ? stdin : fopen(in, "rb");
+  if (!input) {
+    write_to_log("Error: cannot open %s\n", in);
+    free_table(table);
+    return 1;
+  }
+
+  /* Regular files are mapped; pipes and empty files are read instead. */
+  SourceMap src;
+  const char* data = NULL;
+  char* buf = NULL;
+  size_t len;
+  int mapped = source_map(&src, input) == 0;
+  int err = 0;
+  if (mapped) {
+    data = src.data;
+    len = src.len;
+  } else if (read_stream(input, &buf, &len) == 0) {
+    data = buf;
+  } else {
+    write_to_log("Error: cannot read %s\n", in);
+    err = 1;
+  }
+
+  if (!err) {
+    OutputWriter writer;
+    fflush(output);
+    writer_init_fd(&writer, fileno(output));
+    if (disassemble(data, len, format == FORMAT_BIN, table, &writer) != 0) {
+      err = 1;
+    }
+    if (writer_release(&writer) != 0) {
+      err = 1;
+    }
+  }
+  if (mapped) {
+    source_unmap(&src);
+  }
+  free(buf);
+  if (!from_stdin) {
+    fclose(input);
+  }
+  free_table(table);
+  return err;
+}
+
+#ifndef ASSEMBLER_LIBRARY
+
+static void free_inputs(char** inputs, int count) {
+  for (int i = 0; i < count; i++) {
+    free(inputs[i]);
+  }
+  free(inputs);
+}
+
+/* Appends a copy of PATH to the list of inputs. */
+static void add_input(char*** inputs, int* count, int* cap, const char* path) {
+  if (*count == *cap) {
+    int new_cap = *cap ? *cap * 2 : INCREMENT_OF_CAP;
+    char** list = realloc(*inputs, (size_t)new_cap * sizeof(char*));
+    if (!list) {
+      allocation_failed();
+    }
+    *inputs = list;
+    *cap = new_cap;
+  }
+  char* copy = strdup(path);
+  if (!copy) {
+    allocation_failed();
+  }
+  (*inputs)[(*count)++] = copy;
+}
+
+/* Adds every path listed in the manifest file PATH, one per line. Blank
+   lines and lines starting with '#' are skipped. Returns -1 if the manifest
+   cannot be read. */
+static int read_manifest(const char* path, char*** inputs, int* count,
+                         int* cap) {
+  char line[MAX_PATH_LENGTH];
+  FILE* manifest = fopen(path, "r");
+  if (!manifest) {
+    return -1;
+  }
+  while (fgets(line, sizeof(line), manifest)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] != '\0' && line[0] != '#') {
+      add_input(inputs, count, cap, line);
+    }
+  }
+  fclose(manifest);
+  return 0;
+}
+
+/* The option of OPTS that rewrites the whole block after pass one, or NULL
+   if there is none. The single-pass path encodes every line as it is read,
+   so it cannot honour them. */
+static const char* block_rewrite_option(const AssembleOptions* opts) {
+  if (opts->optimize) {
+    return "-O";
+  }
+  if (opts->schedule) {
+    return "--schedule";
+  }
+  if (opts->relax) {
+    return "--relax";
+  }
+  if (opts->compress) {
+    return "--compress";
+  }
+  return NULL;
+}
+
+/*******************************
+ * Server Mode
+ *******************************/
+
+/* Initial size of a connection's output and log buffers. */
+#define SERVE_BUFFER_SIZE (64 * 1024)
+
+/* Set by SIGINT and SIGTERM to stop serve(). */
+static volatile sig_atomic_t stop_serving = 0;
+
+static void handle_stop(int sig) {
+  (void)sig;
+  stop_serving = 1;
+}
+
+typedef struct {
+  int fd;
+  AssembleOptions opts;
+} Connection;
+
+/* Make *BUF hold at least NEED bytes. */
+static int grow_buffer(char** buf, size_t* cap, size_t need) {
+  if (need <= *cap) {
+    return 0;
+  }
+  char* grown = realloc(*buf, need);
+  if (!grown) {
+    return -1;
+  }
+  *buf = grown;
+  *cap = need;
+  return 0;
+}
+
+/* Answers the requests on one connection (see protocol.h) until the client
+   hangs up or sends something malformed. The connection has its own
+   AssembleContext and buffers, so after the first request the symbol table,
+   block and output buffers are already allocated and warm. */
+static void* serve_connection(void* arg) {
+  Connection* conn = arg;
+  AssembleContext* ctx = create_assemble_context();
+  char* src = NULL;
+  char* out = NULL;
+  char* log = NULL;
+  size_t src_cap = 0, out_cap = 0, log_cap = 0;
+  RequestHeader request;
+
+  if (grow_buffer(&out, &out_cap, SERVE_BUFFER_SIZE) != 0 ||
+      grow_buffer(&log, &log_cap, SERVE_BUFFER_SIZE) != 0) {
+    free_assemble_context(ctx);
+    ctx = NULL;
+  }
+  while (ctx && protocol_read(conn->fd, &request, sizeof(request)) == 0) {
+    if (request.format > FORMAT_ELF || request.len > PROTOCOL_MAX_SOURCE ||
+        grow_buffer(&src, &src_cap, request.len) != 0 ||
+        protocol_read(conn->fd, src, request.len) != 0) {
+      break;
+    }
+    AssembleOptions opts = conn->opts;
+    opts.format = (OutputFormat)request.format;
+    AssembleBuffers bufs = {out, out_cap, 0, log, log_cap, 0};
+    int status =
+        assemble_buffer_with_context(ctx, src, request.len, &opts, &bufs);
+    if (bufs.out_len > out_cap || bufs.log_len > log_cap) {
+      /* Larger than anything before on this connection: grow the buffers
+         to the reported sizes and assemble again. */
+      if (grow_buffer(&out, &out_cap, bufs.out_len) != 0 ||
+          grow_buffer(&log, &log_cap, bufs.log_len) != 0) {
+        break;
+      }
+      bufs = (AssembleBuffers){out, out_cap, 0, log, log_cap, 0};
+      status =
+          assemble_buffer_with_context(ctx, src, request.len, &opts, &bufs);
+    }
+    ResponseHeader response = {(uint32_t)status, (uint32_t)bufs.out_len,
+                               (uint32_t)bufs.log_len};
+    if (protocol_send_response(conn->fd, &response, out, log) != 0) {
+      break;
+    }
+  }
+
+  free_assemble_context(ctx);
+  free(src);
+  free(out);
+  free(log);
+  close(conn->fd);
+  free(conn);
+  return NULL;
+}
+
+/* Serves assemble requests on the Unix socket PATH until SIGINT or SIGTERM.
+   Every connection is handled on its own thread, so clients are served
+   concurrently and one process replaces a fork+exec per file. OPTS applies
+   to every request except for the format, which each request chooses. */
+static int serve(const char* path, const AssembleOptions* opts) {
+  int listener = protocol_listen(path);
+  if (listener < 0) {
+    printf("Cannot listen on %s.\n", path);
+    return 1;
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  /* No SA_RESTART, so that accept() returns when a signal arrives. */
+  action.sa_handler = handle_stop;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  /* A client that hangs up early must not take the server down. */
+  action.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &action, NULL);
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  while (!stop_serving) {
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+      continue;
+    }
+    Connection* conn = malloc(sizeof(Connection));
+    pthread_t thread;
+    if (conn) {
+      conn->fd = fd;
+      conn->opts = *opts;
+    }
+    if (!conn || pthread_create(&thread, &attr, serve_connection, conn) != 0) {
+      close(fd);
+      free(conn);
+    }
+  }
+  pthread_attr_destroy(&attr);
+  close(listener);
+  protocol_unlink(path);
+  return 0;
+}
+
 static void print_usage_and_exit(void) {
   printf("Usage:\n");
-  printf("--input_file: The input file of the assembler\n");
+  printf("--input_file: The input file of the assembler; may be repeated;\n"
+         "  - reads standard input\n");
+  printf("--manifest FILE: Also assemble every file listed in FILE\n");
   printf("--output_folder: The output folder of the assembler\n");
+  printf("--jobs N: Run pass two on N threads (default 1); with several\n"
+         "  input files, assemble N files at a time instead\n");
+  printf("--format hex|bin|elf: Encoding of the .out file (default hex)\n");
+  printf("--stdout: Write the output to stdout and diagnostics to stderr;\n"
+         "  the output folder is then optional\n");
+  printf("-O: Remove redundant instructions (moves to the same register,\n"
+         "  values overwritten unread, jumps to the next instruction)\n");
+  printf("--schedule 5stage|7stage: Reorder instructions between labels\n"
+         "  and branches to hide load-use and multiply latencies\n");
+  printf("--disassemble: Print the instructions of the .out image given\n"
+         "  with --input_file (hex, or raw with --format bin) to stdout\n");
+  printf("--symbols FILE: Name the labels of the .tbl FILE in the listing\n");
+  printf("--relax: Lengthen branches and calls whose label is out of range\n");
+  printf("--compress: Emit the 16-bit RVC form of every instruction that\n"
+         "  has one\n");
+  printf("--single_pass: Encode while reading, patching forward references\n");
+  printf("--incremental: Keep NAME.cache in the output folder and only\n"
+         "  reassemble the parts of the input that changed since the last run\n");
+  printf("--stats[=text|json]: Print phase times, counts and memory use of\n"
+         "  each file to stderr\n");
+  printf("--serve SOCKET: Stay resident and answer assemble requests on the\n"
+         "  Unix socket SOCKET (see src/protocol.h) until interrupted\n");
   exit(0);
 }
 
@@ -325,27 +1793,69 @@ int main(int argc, char** argv) {
     OPT_INPUT,
     OPT_OUTPUT,
     OPT_TEST,
+    OPT_JOBS,
+    OPT_FORMAT,
+    OPT_SINGLE_PASS,
+    OPT_MANIFEST,
+    OPT_SERVE,
+    OPT_STATS,
+    OPT_INCREMENTAL,
+    OPT_STDOUT,
+    OPT_OPTIMIZE,
+    OPT_SCHEDULE,
+    OPT_DISASSEMBLE,
+    OPT_SYMBOLS,
+    OPT_RELAX,
+    OPT_COMPRESS,
   };
 
   static struct option long_options[] = {
       {"input_file", required_argument, NULL, OPT_INPUT},
       {"output_folder", required_argument, NULL, OPT_OUTPUT},
       {"test", no_argument, NULL, OPT_TEST},
+      {"jobs", required_argument, NULL, OPT_JOBS},
+      {"format", required_argument, NULL, OPT_FORMAT},
+      {"single_pass", no_argument, NULL, OPT_SINGLE_PASS},
+      {"manifest", required_argument, NULL, OPT_MANIFEST},
+      {"serve", required_argument, NULL, OPT_SERVE},
+      {"stats", optional_argument, NULL, OPT_STATS},
+      {"incremental", no_argument, NULL, OPT_INCREMENTAL},
+      {"stdout", no_argument, NULL, OPT_STDOUT},
+      {"O", no_argument, NULL, OPT_OPTIMIZE},
+      {"schedule", required_argument, NULL, OPT_SCHEDULE},
+      {"disassemble", no_argument, NULL, OPT_DISASSEMBLE},
+      {"symbols", required_argument, NULL, OPT_SYMBOLS},
+      {"relax", no_argument, NULL, OPT_RELAX},
+      {"compress", no_argument, NULL, OPT_COMPRESS},
       {0, 0, 0, 0}};
 
-  char input[MAX_PATH_LENGTH] = {0};
+  char** inputs = NULL;
+  int num_inputs = 0;
+  int inputs_cap = 0;
   char output[MAX_PATH_LENGTH] = {0};
+  const char* socket_path = NULL;
+  int disassemble_mode = 0;
+  const char* symbols = NULL;
 
   int opt;
   char short_options[] = "";
   int option_index = 0;
 
-  int test = 0;
+  AssembleOptions opts;
+  default_assemble_options(&opts);
+  char* end;
+  long jobs;
   while ((opt = getopt_long_only(argc, argv, short_options, long_options,
                                  &option_index)) != -1) {
     switch (opt) {
       case OPT_INPUT:
-        strcpy(input, optarg);
+        add_input(&inputs, &num_inputs, &inputs_cap, optarg);
+        break;
+      case OPT_MANIFEST:
+        if (read_manifest(optarg, &inputs, &num_inputs, &inputs_cap) != 0) {
+          printf("Cannot read manifest %s.\n", optarg);
+          return 1;
+        }
         break;
       case OPT_OUTPUT:
         // If the output folder ends with "/", use it directly.
@@ -357,18 +1867,121 @@ int main(int argc, char** argv) {
         }
         break;
       case OPT_TEST:
-        test = 1;
+        opts.test = 1;
+        break;
+      case OPT_JOBS:
+        jobs = strtol(optarg, &end, 10);
+        if (*end != '\0' || jobs < 1 || jobs > MAX_JOBS) {
+          printf("--jobs expects a number between 1 and %d.\n", MAX_JOBS);
+          return 1;
+        }
+        opts.jobs = (int)jobs;
+        break;
+      case OPT_SINGLE_PASS:
+        opts.single_pass = 1;
+        break;
+      case OPT_INCREMENTAL:
+        opts.incremental = 1;
+        break;
+      case OPT_STDOUT:
+        opts.to_stdout = 1;
+        break;
+      case OPT_OPTIMIZE:
+        opts.optimize = 1;
+        break;
+      case OPT_SCHEDULE:
+        if (!find_pipeline_model(optarg)) {
+          printf("--schedule expects 5stage or 7stage.\n");
+          return 1;
+        }
+        opts.schedule = optarg;
+        break;
+      case OPT_DISASSEMBLE:
+        disassemble_mode = 1;
+        break;
+      case OPT_SYMBOLS:
+        symbols = optarg;
+        break;
+      case OPT_RELAX:
+        opts.relax = 1;
+        break;
+      case OPT_COMPRESS:
+        opts.compress = 1;
+        break;
+      case OPT_SERVE:
+        socket_path = optarg;
+        break;
+      case OPT_STATS:
+        if (!optarg || strcmp(optarg, "text") == 0) {
+          opts.stats = STATS_TEXT;
+        } else if (strcmp(optarg, "json") == 0) {
+          opts.stats = STATS_JSON;
+        } else {
+          printf("--stats expects text or json.\n");
+          return 1;
+        }
+        break;
+      case OPT_FORMAT:
+        if (strcmp(optarg, "hex") == 0) {
+          opts.format = FORMAT_HEX;
+        } else if (strcmp(optarg, "bin") == 0) {
+          opts.format = FORMAT_BIN;
+        } else if (strcmp(optarg, "elf") == 0) {
+          opts.format = FORMAT_ELF;
+        } else {
+          printf("--format expects hex, bin or elf.\n");
+          return 1;
+        }
         break;
       default:
         print_usage_and_exit();
         break;
     }
   }
-  if (strlen(input) == 0 || strlen(output) == 0) {
+  if (socket_path) {
+    return serve(socket_path, &opts);
+  }
+  if (disassemble_mode) {
+    if (num_inputs != 1) {
+      fprintf(stderr, "--disassemble takes a single input file.\n");
+      err = 1;
+    } else {
+      err = disassemble_file(inputs[0], symbols, opts.format, stdout);
+    }
+    free_inputs(inputs, num_inputs);
+    return err;
+  }
+  /* With --stdout only the files of --test go to the output folder, and by
+     default to the current directory. */
+  if (num_inputs == 0 || strlen(inputs[0]) == 0 ||
+      (strlen(output) == 0 && !opts.to_stdout)) {
     printf("Please provide the correct input file and output folder.\n");
     return 0;
   }
-  err = assemble(input, output, test);
+  if (opts.to_stdout && num_inputs > 1) {
+    fprintf(stderr, "--stdout takes a single input file.\n");
+    return 1;
+  }
+  /* A pipeline from stdin to --stdout is assembled in a single pass. */
+  const char* rewrite = block_rewrite_option(&opts);
+  if (rewrite && (opts.single_pass ||
+                  (opts.to_stdout && strcmp(inputs[0], "-") == 0))) {
+    fprintf(stderr,
+            "%s cannot be used with --single_pass or with stdin to "
+            "--stdout.\n",
+            rewrite);
+    free_inputs(inputs, num_inputs);
+    return 1;
+  }
+  if (num_inputs == 1) {
+    err = assemble_with_options(inputs[0], output, &opts);
+  } else {
+    err = assemble_batch((const char* const*)inputs, num_inputs, output,
+                         &opts);
+  }
 
+  free_inputs(inputs, num_inputs);
   return err;
 }
+
+#endif
@@ -7,6 +7,7 @@
 #ifndef ASSEMBLER_H
 #define ASSEMBLER_H
 
+#include <stddef.h>
 #include <stdio.h>
 
 /*******************************
@@ -15,4 +16,148 @@
 
 int assemble(const char* in, const char* out, int test);
 
+/*******************************
+ * Extended Interface
+ *******************************/
+
+/* Encoding of the .out file. */
+typedef enum {
+  FORMAT_HEX, /* one "0x%08X" line per instruction */
+  FORMAT_BIN, /* raw little-endian instruction words */
+  FORMAT_ELF, /* RV32 ELF relocatable with .text and .symtab */
+} OutputFormat;
+
+/* Report printed by --stats. */
+typedef enum {
+  STATS_NONE,
+  STATS_TEXT, /* human-readable table */
+  STATS_JSON, /* one JSON object per input file */
+} StatsFormat;
+
+/* Options for assemble_with_options(). */
+typedef struct {
+  /* Also write the symbol table (.tbl) and instruction block (.inst). */
+  int test;
+  /* Number of threads for pass two; 1 runs it sequentially. */
+  int jobs;
+  /* Encoding of the .out file. */
+  OutputFormat format;
+  /* Encode while reading instead of running two passes over an IrProgram;
+     forward references are backpatched. --jobs has no effect then. */
+  int single_pass;
+  /* Print phase times, counts and memory use of each file to stderr. */
+  StatsFormat stats;
+  /* Reuse what the last run with this option made of the unchanged parts
+     of the input, from NAME.cache next to the output (see src/cache.h).
+     The outputs are the same as without it. Has no effect with test,
+     single_pass, to_stdout, optimize, schedule, relax or compress, or if
+     the input is not a regular file. */
+  int incremental;
+  /* Write the encoded output to stdout and diagnostics to stderr instead of
+     NAME.out and NAME.log in the output folder. With input "-" (stdin) as
+     well, the input is assembled as with single_pass, and output is
+     written as soon as the labels it refers to are known. */
+  int to_stdout;
+  /* Remove redundant instructions after pass one (see src/peephole.h)
+     and log how many. Has no effect with single_pass. */
+  int optimize;
+  /* Name of the pipeline model (see src/schedule.h: "5stage" or "7stage")
+     to reorder instructions for after pass one, hiding load-use and
+     multiply latencies, or NULL to keep the source order. The saved stall
+     cycles are logged. Has no effect with single_pass. */
+  const char* schedule;
+  /* Rewrite branches and calls whose label is out of range into longer
+     sequences that reach it (see src/relax.h) instead of reporting them.
+     Has no effect with single_pass. */
+  int relax;
+  /* Emit every instruction that has a 16-bit RVC form in that form, and
+     lay the labels out for the mixed 2- and 4-byte code (see
+     src/compress.h). In hex output a compressed instruction is one
+     "0x%04X" line. Has no effect with single_pass. */
+  int compress;
+} AssembleOptions;
+
+/* Fills OPTS with the defaults used by assemble(). */
+void default_assemble_options(AssembleOptions* opts);
+
+/* Like assemble(), with the behaviour selected by OPTS. */
+int assemble_with_options(const char* in, const char* out,
+                          const AssembleOptions* opts);
+
+/* Assembles each of the COUNT files in INPUTS into OUT with OPTS, on up to
+   OPTS->jobs threads (one file per thread at a time). Each file's outputs
+   are identical to a standalone assemble_with_options() run. Returns 1 if
+   any file failed, 0 otherwise. Nothing is assembled, and 1 is returned,
+   if two files would have the same outputs in OUT (a/x.s and b/x.s). */
+int assemble_batch(const char* const* inputs, int count, const char* out,
+                   const AssembleOptions* opts);
+
+/* Writes the instructions of the .out image IN ("-" for stdin) to OUTPUT as
+   assembly (see src/disasm.h). FORMAT is FORMAT_HEX or FORMAT_BIN. If
+   SYMBOLS names a .tbl file, its labels are placed in the listing and name
+   branch and jump targets, and assembling the listing gives back IN.
+   Errors go to the log. Returns 1 on failure, 0 otherwise. */
+int disassemble_file(const char* in, const char* symbols, OutputFormat format,
+                     FILE* output);
+
+/*******************************
+ * Library Interface
+ *******************************/
+
+/* Results of assemble_buffer(). */
+typedef enum {
+  ASSEMBLE_OK = 0,
+  /* The source has errors; the log lists them. The output holds the
+     instructions that did assemble, as the .out file would. */
+  ASSEMBLE_ERR_SOURCE,
+  /* Memory ran out. Nothing is leaked and the process carries on. */
+  ASSEMBLE_ERR_NOMEM,
+  /* The output did not fit; OUT_LEN is the size needed. */
+  ASSEMBLE_ERR_SPACE,
+  /* A NULL or otherwise unusable argument. */
+  ASSEMBLE_ERR_ARGS,
+} AssembleStatus;
+
+/* Caller-supplied memory for assemble_buffer(). */
+typedef struct {
+  /* Receives the encoded program in the selected format. */
+  char* out;
+  size_t out_cap;
+  /* Set to the size of the whole output, even if it exceeds OUT_CAP. */
+  size_t out_len;
+  /* Receives the text of the .log file, cut short at LOG_CAP bytes and not
+     NUL-terminated. May be NULL when LOG_CAP is 0. */
+  char* log;
+  size_t log_cap;
+  /* Set to the size of the whole log, even if it exceeds LOG_CAP. */
+  size_t log_len;
+} AssembleBuffers;
+
+/* Assembles the LEN bytes at SRC and writes the output and the log into
+   BUFS. Works entirely in memory: no files are opened, the process never
+   exits, and the calling thread's logger is left as it was, so any number
+   of threads may call this at once. OPTS may be NULL for the defaults;
+   only OPTS->jobs, OPTS->format, OPTS->optimize, OPTS->schedule,
+   OPTS->relax and OPTS->compress are used. An unknown OPTS->schedule model
+   is reported in the log and returns ASSEMBLE_ERR_SOURCE.
+   Returns an AssembleStatus; ASSEMBLE_ERR_SPACE takes precedence over
+   ASSEMBLE_ERR_SOURCE. */
+int assemble_buffer(const char* src, size_t len, const AssembleOptions* opts,
+                    AssembleBuffers* bufs);
+
+/* Memory that assemble_buffer() allocates, kept from one call to the next
+   so that a caller assembling many sources reuses it. A context belongs to
+   one thread at a time. */
+typedef struct AssembleContext AssembleContext;
+
+/* Returns a new context, or NULL if memory runs out. */
+AssembleContext* create_assemble_context(void);
+
+void free_assemble_context(AssembleContext* ctx);
+
+/* assemble_buffer() with the memory of CTX. */
+int assemble_buffer_with_context(AssembleContext* ctx, const char* src,
+                                 size_t len, const AssembleOptions* opts,
+                                 AssembleBuffers* bufs);
+
 #endif
@@ -0,0 +1,107 @@
+/* Allocation benchmark for the instruction Block.
+
+   Feeds a synthetic mix of source lines through write_pass_one(), as
+   pass_one() does, and counts the heap allocations made along the way by
+   wrapping malloc/calloc/realloc at link time (-Wl,--wrap=...). Reports
+   malloc/calloc calls and the bytes they request per source line, and the
+   number of realloc calls (array growth) separately.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/block.h"
+#include "../src/translate.h"
+
+#define NUM_LINES 1000000
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+static size_t alloc_count = 0;
+static size_t alloc_bytes = 0;
+static size_t realloc_count = 0;
+
+void* __wrap_malloc(size_t size) {
+  alloc_count++;
+  alloc_bytes += size;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size) {
+  alloc_count++;
+  alloc_bytes += nmemb * size;
+  return __real_calloc(nmemb, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  realloc_count++;
+  return __real_realloc(ptr, size);
+}
+
+typedef struct {
+  const char* name;
+  int num_args;
+  const char* args[MAX_ARGS];
+} SourceLine;
+
+static const SourceLine lines[] = {
+    {"addi", 3, {"sp", "sp", "-16"}}, {"sw", 3, {"ra", "12", "sp"}},
+    {"lw", 3, {"a0", "0", "a1"}},     {"add", 3, {"a0", "a0", "a2"}},
+    {"li", 2, {"t0", "100000"}},      {"mv", 2, {"a1", "s0"}},
+    {"beq", 3, {"a0", "x0", "loop"}}, {"jal", 1, {"helper"}},
+    {"slli", 3, {"t1", "t1", "2"}},   {"bnez", 2, {"t1", "loop"}},
+};
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+  char arg_bufs[MAX_ARGS][32];
+  char* args[MAX_ARGS];
+  for (int i = 0; i < MAX_ARGS; i++) {
+    args[i] = arg_bufs[i];
+  }
+
+  size_t count_before = alloc_count;
+  size_t bytes_before = alloc_bytes;
+  size_t reallocs_before = realloc_count;
+  double start = now_sec();
+
+  Block* blk = create_block();
+  for (uint32_t i = 0; i < NUM_LINES; i++) {
+    const SourceLine* line = &lines[i % ARRAY_LEN(lines)];
+    /* Copy into scratch buffers like strtok() tokens of the line buffer. */
+    for (int j = 0; j < line->num_args; j++) {
+      strcpy(arg_bufs[j], line->args[j]);
+    }
+    blk->line_number = i + 1;
+    write_pass_one(blk, line->name, args, line->num_args);
+  }
+  uint32_t instructions = blk->len;
+  free_block(blk);
+
+  double end = now_sec();
+  size_t count = alloc_count - count_before;
+  size_t bytes = alloc_bytes - bytes_before;
+  size_t reallocs = realloc_count - reallocs_before;
+
+  printf("%10s %12s %12s %12s %10s %10s\n", "lines", "instructions",
+         "allocs/line", "bytes/line", "reallocs", "ns/line");
+  printf("%10u %12u %12.3f %12.1f %10zu %10.1f\n", NUM_LINES, instructions,
+         (double)count / NUM_LINES, (double)bytes / NUM_LINES, reallocs,
+         (end - start) * 1e9 / NUM_LINES);
+  return 0;
+}
@@ -0,0 +1,122 @@
+/* Disassembler decode benchmark.
+
+   Decodes a fixed stream of instruction words, once by scanning
+   `instr_table` for the entry whose opcode, funct3 and funct7 match, and
+   once through the DecodeTable lookup of disassemble(). The two are
+   compared first, so the benchmark fails if the table ever decodes a word
+   differently. Then times disassemble() on the same words as a hex image.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/disasm.h"
+#include "../src/writer.h"
+
+#define NUM_WORDS 4000000
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* The InstrId of WORD by a linear scan of `instr_table`, or IR_INVALID. */
+static uint8_t scan_table(uint32_t word) {
+  uint32_t opcode = word & 0x7F;
+  uint32_t funct3 = (word >> 12) & 0x7;
+  uint32_t funct7 = word >> 25;
+  for (int id = 0; id < NUM_INSTRS; id++) {
+    const InstrInfo* info = instr_info((InstrId)id);
+    if (info->opcode != opcode) {
+      continue;
+    }
+    if (info->instr_type != U_TYPE && info->instr_type != UJ_TYPE &&
+        info->funct3 != funct3) {
+      continue;
+    }
+    if ((info->instr_type == R_TYPE || info->imm_type == IMM_5_UNSIGNED) &&
+        info->funct7 != funct7) {
+      continue;
+    }
+    /* ecall has no operands at all. */
+    if (info->instr_type == I_TYPE && info->imm_type == IMM_NONE &&
+        word != opcode) {
+      continue;
+    }
+    return (uint8_t)id;
+  }
+  return IR_INVALID;
+}
+
+int main(void) {
+  uint32_t* words = malloc(sizeof(uint32_t) * NUM_WORDS);
+  uint8_t* scanned = malloc(NUM_WORDS);
+  uint8_t* looked_up = malloc(NUM_WORDS);
+  if (!words || !scanned || !looked_up) {
+    return 1;
+  }
+  /* Mostly valid words: random fields under the major opcodes in use. */
+  static const uint32_t opcodes[] = {0x33, 0x13, 0x03, 0x23, 0x63,
+                                     0x37, 0x17, 0x6F, 0x67, 0x73};
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t fields = seed & ~0x7Fu & ~0xFC000000u;
+    words[i] = fields | opcodes[(seed >> 26) % 10];
+  }
+
+  DecodeTable table;
+  build_decode_table(&table);
+  double start = now_sec();
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    scanned[i] = scan_table(words[i]);
+  }
+  double mid = now_sec();
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    IrInstr ir;
+    looked_up[i] = decode_word(&table, words[i], &ir) == 0 ? ir.op
+                                                          : IR_INVALID;
+  }
+  double end = now_sec();
+  if (memcmp(scanned, looked_up, NUM_WORDS) != 0) {
+    fprintf(stderr, "table decode differs from the instr_table scan\n");
+    return 1;
+  }
+
+  OutputWriter image;
+  OutputWriter listing;
+  writer_init_memory(&image);
+  writer_init_memory(&listing);
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    writer_put_hex(&image, words[i]);
+  }
+  double listing_start = now_sec();
+  if (image.error ||
+      disassemble(image.buf, image.len, 0, NULL, &listing) != 0 ||
+      listing.error) {
+    fprintf(stderr, "disassemble failed\n");
+    return 1;
+  }
+  double listing_end = now_sec();
+
+  printf("%-12s %12s\n", "decoder", "ns/word");
+  printf("%-12s %12.1f\n", "scan", (mid - start) * 1e9 / NUM_WORDS);
+  printf("%-12s %12.1f\n", "table", (end - mid) * 1e9 / NUM_WORDS);
+  printf("%-12s %12.1f\n", "disassemble",
+         (listing_end - listing_start) * 1e9 / NUM_WORDS);
+  printf("%.1f MB hex image in %.3f s\n", (double)image.len / 1e6,
+         listing_end - listing_start);
+
+  writer_release(&image);
+  writer_release(&listing);
+  free(words);
+  free(scanned);
+  free(looked_up);
+  return 0;
+}
@@ -0,0 +1,120 @@
+/* Microbenchmark for mnemonic dispatch.
+
+   Compares find_instr_info() / find_pseudo_handler() against the linear
+   strcmp scans over the same tables that translate_inst() and
+   write_pass_one() used before, on a mnemonic mix weighted like compiler
+   output (mostly addi/lw/sw/add/branches, some pseudo-instructions).
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/translate.h"
+
+#define NUM_LOOKUPS 2000000
+
+typedef struct {
+  const char* name;
+  unsigned weight;
+} MixEntry;
+
+static const MixEntry mix[] = {
+    {"addi", 20}, {"lw", 14}, {"sw", 10}, {"add", 8},  {"beq", 5},
+    {"bne", 5},   {"jal", 5}, {"mv", 6},  {"li", 6},   {"slli", 3},
+    {"sub", 3},   {"and", 2}, {"or", 2},  {"lui", 2},  {"jalr", 2},
+    {"j", 2},     {"lbu", 2}, {"sb", 1},  {"blt", 1},  {"bgeu", 1},
+    {"beqz", 2},  {"bnez", 2}, {"mul", 1}, {"auipc", 1}, {"ecall", 1},
+};
+
+/* Table order of the linear scans being replaced. */
+static const char* const pseudo_names[] = {"beqz", "bnez", "li",   "mv", "j",
+                                           "jr",   "jal",  "jalr", "lw"};
+static const char* const instr_names[] = {
+    "add",  "sub",  "xor",  "or",    "and",  "sll",  "srl",  "sra",  "slt",
+    "sltu", "mul",  "mulh", "div",   "rem",  "addi", "xori", "ori",  "andi",
+    "slli", "srli", "srai", "slti",  "sltiu", "lb",  "lh",   "lw",   "lbu",
+    "lhu",  "jalr", "ecall", "sb",   "sh",   "sw",   "beq",  "bne",  "blt",
+    "bge",  "bltu", "bgeu", "lui",   "auipc", "jal"};
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static size_t linear_scan(const char* const* names, size_t len,
+                          const char* name) {
+  for (size_t i = 0; i < len; i++) {
+    if (strcmp(name, names[i]) == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/* Pass one asks for a pseudo handler first, pass two for the InstrInfo. */
+static size_t run_linear(const char** corpus) {
+  size_t hits = 0;
+  for (size_t i = 0; i < NUM_LOOKUPS; i++) {
+    hits += linear_scan(pseudo_names, ARRAY_LEN(pseudo_names), corpus[i]) != 0;
+    hits += linear_scan(instr_names, ARRAY_LEN(instr_names), corpus[i]) != 0;
+  }
+  return hits;
+}
+
+static size_t run_switch(const char** corpus) {
+  size_t hits = 0;
+  for (size_t i = 0; i < NUM_LOOKUPS; i++) {
+    hits += find_pseudo_handler(corpus[i]) != NULL;
+    hits += find_instr_info(corpus[i]) != NULL;
+  }
+  return hits;
+}
+
+int main(void) {
+  const char** corpus = malloc(sizeof(*corpus) * NUM_LOOKUPS);
+  if (!corpus) {
+    return 1;
+  }
+
+  unsigned total_weight = 0;
+  for (size_t i = 0; i < ARRAY_LEN(mix); i++) {
+    total_weight += mix[i].weight;
+  }
+  /* Fixed-seed LCG so every run sees the same corpus. */
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < NUM_LOOKUPS; i++) {
+    seed = seed * 1103515245u + 12345u;
+    unsigned pick = (seed >> 16) % total_weight;
+    size_t j = 0;
+    while (pick >= mix[j].weight) {
+      pick -= mix[j++].weight;
+    }
+    corpus[i] = mix[j].name;
+  }
+
+  double start = now_sec();
+  size_t linear_hits = run_linear(corpus);
+  double mid = now_sec();
+  size_t switch_hits = run_switch(corpus);
+  double end = now_sec();
+
+  printf("%-8s %12s\n", "dispatch", "ns/lookup");
+  printf("%-8s %12.1f\n", "linear", (mid - start) * 1e9 / NUM_LOOKUPS);
+  printf("%-8s %12.1f\n", "switch", (end - mid) * 1e9 / NUM_LOOKUPS);
+
+  free(corpus);
+  if (linear_hits == 0 || linear_hits != switch_hits) {
+    fprintf(stderr, "dispatch mismatch: %zu vs %zu\n", linear_hits,
+            switch_hits);
+    return 1;
+  }
+  return 0;
+}
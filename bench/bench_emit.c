@@ -0,0 +1,90 @@
+/* Hex emission benchmark.
+
+   Formats a fixed stream of instruction words as "0x%08X\n" lines, once
+   with fprintf() the way pass two used to and once through an OutputWriter,
+   both into temporary files. The two files are compared first, so the
+   benchmark fails if the writer's output ever differs from fprintf().
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/writer.h"
+
+#define NUM_WORDS 4000000
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Reads all of FILE into a malloc'd buffer; sets *LEN. */
+static char* slurp(FILE* file, long* len) {
+  fflush(file);
+  fseek(file, 0, SEEK_END);
+  *len = ftell(file);
+  rewind(file);
+  char* buf = malloc((size_t)*len + 1);
+  if (buf && fread(buf, 1, (size_t)*len, file) != (size_t)*len) {
+    free(buf);
+    return NULL;
+  }
+  return buf;
+}
+
+int main(void) {
+  uint32_t* words = malloc(sizeof(uint32_t) * NUM_WORDS);
+  FILE* with_printf = tmpfile();
+  FILE* with_writer = tmpfile();
+  if (!words || !with_printf || !with_writer) {
+    return 1;
+  }
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    seed = seed * 1103515245u + 12345u;
+    words[i] = seed;
+  }
+
+  double start = now_sec();
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    fprintf(with_printf, "0x%08X\n", words[i]);
+  }
+  fflush(with_printf);
+  double mid = now_sec();
+  OutputWriter writer;
+  writer_init_fd(&writer, fileno(with_writer));
+  for (size_t i = 0; i < NUM_WORDS; i++) {
+    writer_put_hex(&writer, words[i]);
+  }
+  if (writer_release(&writer) != 0) {
+    fprintf(stderr, "writer failed\n");
+    return 1;
+  }
+  double end = now_sec();
+
+  long printf_len, writer_len;
+  char* expected = slurp(with_printf, &printf_len);
+  char* actual = slurp(with_writer, &writer_len);
+  if (!expected || !actual || printf_len != writer_len ||
+      memcmp(expected, actual, (size_t)printf_len) != 0) {
+    fprintf(stderr, "writer output differs from fprintf\n");
+    return 1;
+  }
+
+  printf("%-8s %12s\n", "emitter", "ns/word");
+  printf("%-8s %12.1f\n", "fprintf", (mid - start) * 1e9 / NUM_WORDS);
+  printf("%-8s %12.1f\n", "writer", (end - mid) * 1e9 / NUM_WORDS);
+
+  free(expected);
+  free(actual);
+  free(words);
+  fclose(with_printf);
+  fclose(with_writer);
+  return 0;
+}
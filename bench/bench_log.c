@@ -0,0 +1,127 @@
+/* Diagnostic logging benchmark.
+
+   Logs the diagnostics of an input with NUM_ERRORS invalid instructions,
+   in the form raise_instruction_error() writes them, once through a copy
+   of the old logger that opened and closed the log file for every message
+   and once through write_to_log()/log_inst(). The two log files are
+   compared first, so the benchmark fails if the output ever differs.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/utils.h"
+
+#define NUM_ERRORS 100000
+
+static const char* old_log_file;
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void old_write_to_log(char* fmt, ...) {
+  va_list args;
+  FILE* f = fopen(old_log_file, "a");
+  if (!f) {
+    return;
+  }
+  va_start(args, fmt);
+  vfprintf(f, fmt, args);
+  va_end(args);
+  fclose(f);
+}
+
+static void old_log_inst(const char* name, char** args, int num_args) {
+  FILE* f = fopen(old_log_file, "a");
+  if (!f) {
+    return;
+  }
+  fprintf(f, "%s", name);
+  for (int i = 0; i < num_args; i++) {
+    fprintf(f, " %s", args[i]);
+  }
+  fprintf(f, "\n");
+  fclose(f);
+}
+
+/* Reads the file at PATH into a malloc'd buffer; sets *LEN. */
+static char* slurp(const char* path, long* len) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  *len = ftell(file);
+  rewind(file);
+  char* buf = malloc((size_t)*len + 1);
+  if (buf && fread(buf, 1, (size_t)*len, file) != (size_t)*len) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(file);
+  return buf;
+}
+
+int main(void) {
+  char old_path[] = "/tmp/bench_log_old_XXXXXX";
+  char new_path[] = "/tmp/bench_log_new_XXXXXX";
+  int old_fd = mkstemp(old_path);
+  int new_fd = mkstemp(new_path);
+  if (old_fd < 0 || new_fd < 0) {
+    return 1;
+  }
+  close(old_fd);
+  close(new_fd);
+  char* args[] = {"t0", "t1", "bogus"};
+
+  old_log_file = old_path;
+  unlink(old_path);
+  double start = now_sec();
+  for (int i = 0; i < NUM_ERRORS; i++) {
+    old_write_to_log("Error - invalid instruction at line %d: ", i + 1);
+    old_log_inst("addx", args, 3);
+  }
+  old_write_to_log(
+      "One or more errors encountered during assembly operation.\n");
+  double mid = now_sec();
+  set_log_file(new_path);
+  for (int i = 0; i < NUM_ERRORS; i++) {
+    write_to_log("Error - invalid instruction at line %d: ", i + 1);
+    log_inst("addx", args, 3);
+  }
+  write_to_log("One or more errors encountered during assembly operation.\n");
+  close_log();
+  double end = now_sec();
+  set_log_file(NULL);
+
+  long old_len, new_len;
+  char* expected = slurp(old_path, &old_len);
+  char* actual = slurp(new_path, &new_len);
+  unlink(old_path);
+  unlink(new_path);
+  if (!expected || !actual || old_len != new_len ||
+      memcmp(expected, actual, (size_t)old_len) != 0) {
+    fprintf(stderr, "buffered log differs from per-message log\n");
+    return 1;
+  }
+
+  printf("%-10s %12s %12s\n", "logger", "ms total", "ns/error");
+  printf("%-10s %12.1f %12.1f\n", "per-open", (mid - start) * 1e3,
+         (mid - start) * 1e9 / NUM_ERRORS);
+  printf("%-10s %12.1f %12.1f\n", "buffered", (end - mid) * 1e3,
+         (end - mid) * 1e9 / NUM_ERRORS);
+
+  free(expected);
+  free(actual);
+  return 0;
+}
@@ -0,0 +1,170 @@
+/* Resident server latency benchmark.
+
+   Assembles test/in/full_inst.s NUM_RUNS times in three ways and reports
+   the median and 99th percentile latency of one file:
+
+     fork+exec   a new ./assembler process per file, as CI does today
+     client      a new ./asm_client process per file, talking to a resident
+                 `./assembler --serve`
+     connection  one request on an open connection to the server, the cost
+                 for a client that keeps its connection
+
+   The server's output and log are compared with the fork+exec run's files
+   first, so the benchmark fails if they ever differ. Run from the
+   repository root after `make`.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../assembler.h"
+#include "../src/protocol.h"
+
+#define NUM_RUNS 200
+#define INPUT "test/in/full_inst.s"
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Reads the file at PATH into a malloc'd buffer; sets *LEN. */
+static char* slurp(const char* path, long* len) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  *len = ftell(file);
+  rewind(file);
+  char* buf = malloc((size_t)*len + 1);
+  if (buf && fread(buf, 1, (size_t)*len, file) != (size_t)*len) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(file);
+  return buf;
+}
+
+/* Runs ARGV[0] with ARGV and waits for it. Returns its exit status. */
+static int run(char* const* argv) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    execv(argv[0], argv);
+    _exit(127);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+static void report(const char* name, double* samples) {
+  qsort(samples, NUM_RUNS, sizeof(double), compare_doubles);
+  printf("  %-11s median %8.1f us   p99 %8.1f us\n", name,
+         samples[NUM_RUNS / 2] * 1e6, samples[NUM_RUNS * 99 / 100] * 1e6);
+}
+
+int main(void) {
+  char dir[] = "/tmp/bench_serve_XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  char socket_path[64], folder[64], out_path[96], log_path[96];
+  snprintf(socket_path, sizeof(socket_path), "%s/socket", dir);
+  snprintf(folder, sizeof(folder), "%s/", dir);
+  snprintf(out_path, sizeof(out_path), "%s/full_inst.out", dir);
+  snprintf(log_path, sizeof(log_path), "%s/full_inst.log", dir);
+
+  long src_len;
+  char* src = slurp(INPUT, &src_len);
+  if (!src) {
+    fprintf(stderr, "cannot read %s; run from the repository root\n", INPUT);
+    return 1;
+  }
+
+  pid_t server = fork();
+  if (server == 0) {
+    execl("./assembler", "assembler", "--serve", socket_path, (char*)NULL);
+    _exit(127);
+  }
+  int fd = -1;
+  for (int i = 0; i < 100 && fd < 0; i++) {
+    fd = protocol_connect(socket_path);
+    if (fd < 0) {
+      nanosleep(&(struct timespec){0, 10000000}, NULL);
+    }
+  }
+  if (fd < 0) {
+    fprintf(stderr, "server did not start\n");
+    return 1;
+  }
+
+  char* assembler_argv[] = {"./assembler", "--input_file", INPUT,
+                            "--output_folder", folder, NULL};
+  char* client_argv[] = {"./asm_client",    "--serve", socket_path,
+                         "--input_file",    INPUT,     "--output_folder",
+                         folder,            NULL};
+
+  /* Correctness: the server must reproduce the files of a normal run. */
+  Response resp = {0};
+  run(assembler_argv);
+  long out_len, log_len;
+  char* out = slurp(out_path, &out_len);
+  char* log = slurp(log_path, &log_len);
+  if (protocol_send_request(fd, FORMAT_HEX, src, (uint32_t)src_len) != 0 ||
+      protocol_recv_response(fd, &resp) != 0 || !out || !log ||
+      resp.header.out_len != (uint32_t)out_len ||
+      resp.header.log_len != (uint32_t)log_len ||
+      memcmp(resp.out, out, (size_t)out_len) != 0 ||
+      memcmp(resp.log, log, (size_t)log_len) != 0) {
+    fprintf(stderr, "server output differs from the assembler's\n");
+    return 1;
+  }
+
+  static double fork_exec[NUM_RUNS], client[NUM_RUNS], connection[NUM_RUNS];
+  for (int i = 0; i < NUM_RUNS; i++) {
+    double start = now_sec();
+    run(assembler_argv);
+    double mid = now_sec();
+    run(client_argv);
+    double mid2 = now_sec();
+    protocol_send_request(fd, FORMAT_HEX, src, (uint32_t)src_len);
+    protocol_recv_response(fd, &resp);
+    double end = now_sec();
+    fork_exec[i] = mid - start;
+    client[i] = mid2 - mid;
+    connection[i] = end - mid2;
+  }
+
+  printf("%s (%ld bytes), %d runs each:\n", INPUT, src_len, NUM_RUNS);
+  report("fork+exec", fork_exec);
+  report("client", client);
+  report("connection", connection);
+
+  close(fd);
+  kill(server, SIGTERM);
+  waitpid(server, NULL, 0);
+  unlink(out_path);
+  unlink(log_path);
+  rmdir(dir);
+  protocol_response_release(&resp);
+  free(src);
+  free(out);
+  free(log);
+  return 0;
+}
@@ -0,0 +1,63 @@
+/* Scaling benchmark for the SymbolTable.
+
+   Builds tables of increasing size in SYMBOLTBL_UNIQUE_NAME mode (the mode
+   used by pass_one()) and then resolves every symbol once, the way
+   pass_two() does. With the hash index both phases should grow linearly,
+   i.e. the ns/op columns should stay roughly flat as N grows.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/tables.h"
+
+#define NAME_LEN 32
+#define MAX_SYMBOLS 1000000
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+  char(*names)[NAME_LEN] = malloc(sizeof(*names) * MAX_SYMBOLS);
+  if (!names) {
+    return 1;
+  }
+  for (uint32_t i = 0; i < MAX_SYMBOLS; ++i) {
+    snprintf(names[i], NAME_LEN, "L_func%u_bb%u", i / 16, i % 16);
+  }
+
+  printf("%10s %14s %14s\n", "symbols", "insert ns/op", "lookup ns/op");
+  for (uint32_t n = 1000; n <= MAX_SYMBOLS; n *= 10) {
+    SymbolTable* tbl = create_table(SYMBOLTBL_UNIQUE_NAME);
+
+    double start = now_sec();
+    for (uint32_t i = 0; i < n; ++i) {
+      add_to_table(tbl, names[i], i * 4);
+    }
+    double inserted = now_sec();
+
+    int64_t checksum = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+      checksum += get_addr_for_symbol(tbl, names[n - 1 - i]);
+    }
+    double looked_up = now_sec();
+
+    if (checksum != (int64_t)n * (n - 1) * 2) {
+      fprintf(stderr, "lookup mismatch at n=%u\n", n);
+      return 1;
+    }
+    printf("%10u %14.1f %14.1f\n", n, (inserted - start) * 1e9 / n,
+           (looked_up - inserted) * 1e9 / n);
+    free_table(tbl);
+  }
+
+  free(names);
+  return 0;
+}
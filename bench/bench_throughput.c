@@ -0,0 +1,161 @@
+/* Assembler throughput benchmark.
+
+   Generates every workload preset of workload.h (200000 instruction lines
+   each, or argv[1]) and measures three stages:
+
+     pass_one    pass_one_mapped() over the source in memory into an
+                 IrProgram, including the scan and the diagnostics
+     pass_two    pass_two_ir() of that IrProgram into memory
+     end_to_end  assemble_with_options() on a file, as the command line does
+
+   Each stage runs REPS times and the fastest run is reported, as lines and
+   source bytes per second. Every workload is printed with its size and a
+   checksum, so numbers from different versions are only compared when they
+   measured the same input. Run from the repository root.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../assembler.h"
+#include "../src/block.h"
+#include "../src/ir.h"
+#include "../src/source.h"
+#include "../src/tables.h"
+#include "../src/utils.h"
+#include "../src/writer.h"
+#include "workload.h"
+
+#define DEFAULT_LINES 200000
+#define REPS 5
+
+/* The passes are defined in assembler.c, which has no header for them. */
+int pass_one_mapped(SourceMap* src, Block* blk, IrProgram* prog,
+                    SymbolTable* table);
+int pass_two_ir(IrProgram* prog, SymbolTable* table, OutputWriter* output,
+                int jobs);
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* FNV-1a over the source, to identify a workload. */
+static uint32_t checksum(const char* data, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (unsigned char)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static void report(const char* workload, const char* stage, uint32_t lines,
+                   size_t bytes, double best) {
+  printf("%-8s %-10s %10.3f ms %12.0f lines/s %10.2f MB/s\n", workload, stage,
+         best * 1e3, lines / best, bytes / best / 1e6);
+}
+
+/* Pass one over SRC; the passes' state is left in *TBL and PROG for the
+   caller to free. Returns the elapsed time. */
+static double time_pass_one(const char* src, size_t len, SourceMap* map,
+                            SymbolTable** tbl, IrProgram* prog) {
+  source_view(map, src, len);
+  double start = now_sec();
+  *tbl = create_table_with_capacity(SYMBOLTBL_UNIQUE_NAME,
+                                    (uint32_t)(len / 256));
+  Block* blk = create_block();
+  ir_init(prog, (uint32_t)(len / 16));
+  pass_one_mapped(map, blk, prog, *tbl);
+  free_block(blk);
+  return now_sec() - start;
+}
+
+int main(int argc, char** argv) {
+  uint32_t num_lines = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10)
+                                : DEFAULT_LINES;
+  char dir[] = "/tmp/bench_throughput_XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  char in_path[64], folder[64], out_path[64], log_path[64];
+  snprintf(in_path, sizeof(in_path), "%s/input.s", dir);
+  snprintf(folder, sizeof(folder), "%s/", dir);
+  snprintf(out_path, sizeof(out_path), "%s/input.out", dir);
+  snprintf(log_path, sizeof(log_path), "%s/input.log", dir);
+
+  /* Diagnostics go to memory, so that the errors workload measures
+     formatting them rather than the terminal. */
+  OutputWriter log;
+  writer_init_memory(&log);
+  set_log_writer(&log);
+
+  printf("%d instruction lines per workload, best of %d runs\n", num_lines,
+         REPS);
+  for (int w = 0; w < num_workload_presets; w++) {
+    const WorkloadPreset* preset = &workload_presets[w];
+    WorkloadOptions opts = preset->opts;
+    opts.lines = num_lines;
+    size_t len;
+    uint32_t lines;
+    char* src = generate_workload(&opts, &len, &lines);
+    FILE* file = fopen(in_path, "w");
+    if (!src || !file || fwrite(src, 1, len, file) != len) {
+      fprintf(stderr, "cannot write %s\n", in_path);
+      return 1;
+    }
+    fclose(file);
+    printf("%-8s %u lines, %zu bytes, checksum %08x\n", preset->name, lines,
+           len, checksum(src, len));
+
+    double best_one = 1e30, best_two = 1e30, best_all = 1e30;
+    for (int rep = 0; rep < REPS; rep++) {
+      SourceMap map;
+      SymbolTable* tbl;
+      IrProgram prog;
+      writer_reset(&log);
+      double t = time_pass_one(src, len, &map, &tbl, &prog);
+      best_one = t < best_one ? t : best_one;
+
+      OutputWriter out;
+      writer_init_memory(&out);
+      double start = now_sec();
+      pass_two_ir(&prog, tbl, &out, 1);
+      t = now_sec() - start;
+      best_two = t < best_two ? t : best_two;
+      ir_release(&prog);
+      writer_release(&out);
+      free_table(tbl);
+      source_unmap(&map);
+
+      AssembleOptions asm_opts;
+      default_assemble_options(&asm_opts);
+      set_log_writer(NULL);
+      start = now_sec();
+      assemble_with_options(in_path, folder, &asm_opts);
+      t = now_sec() - start;
+      set_log_writer(&log);
+      best_all = t < best_all ? t : best_all;
+    }
+    report(preset->name, "pass_one", lines, len, best_one);
+    report(preset->name, "pass_two", lines, len, best_two);
+    report(preset->name, "end_to_end", lines, len, best_all);
+    free(src);
+  }
+
+  set_log_writer(NULL);
+  writer_release(&log);
+  unlink(in_path);
+  unlink(out_path);
+  unlink(log_path);
+  rmdir(dir);
+  return 0;
+}
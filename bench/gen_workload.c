@@ -0,0 +1,126 @@
+/* Writes a synthetic RISC-V source (see workload.h) to standard output.
+
+     gen_workload [--preset mixed|arith|branchy|pseudo|errors] [--lines N]
+                  [--seed S] [--mix r=40,i=25,mem=15,branch=12,jump=5,upper=3]
+                  [--label_density P] [--forward_ratio P]
+                  [--pseudo_ratio P] [--error_rate P]
+
+   Options after --preset override its settings; the default preset is
+   "mixed" with 100000 lines. The same options always give the same file.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "workload.h"
+
+/* Parses a probability in [0, 1] into *OUT. */
+static int parse_ratio(const char* arg, double* out) {
+  char* end;
+  double value = strtod(arg, &end);
+  if (end == arg || *end != '\0' || value < 0.0 || value > 1.0) {
+    return -1;
+  }
+  *out = value;
+  return 0;
+}
+
+static int usage(const char* prog) {
+  fprintf(stderr,
+          "Usage: %s [--preset NAME] [--lines N] [--seed S] [--mix SPEC]\n"
+          "  [--label_density P] [--forward_ratio P] [--pseudo_ratio P]\n"
+          "  [--error_rate P]\n",
+          prog);
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  enum OPTIONS {
+    OPT_PRESET,
+    OPT_LINES,
+    OPT_SEED,
+    OPT_MIX,
+    OPT_LABEL_DENSITY,
+    OPT_FORWARD_RATIO,
+    OPT_PSEUDO_RATIO,
+    OPT_ERROR_RATE,
+  };
+  static struct option long_options[] = {
+      {"preset", required_argument, NULL, OPT_PRESET},
+      {"lines", required_argument, NULL, OPT_LINES},
+      {"seed", required_argument, NULL, OPT_SEED},
+      {"mix", required_argument, NULL, OPT_MIX},
+      {"label_density", required_argument, NULL, OPT_LABEL_DENSITY},
+      {"forward_ratio", required_argument, NULL, OPT_FORWARD_RATIO},
+      {"pseudo_ratio", required_argument, NULL, OPT_PSEUDO_RATIO},
+      {"error_rate", required_argument, NULL, OPT_ERROR_RATE},
+      {0, 0, 0, 0}};
+
+  WorkloadOptions opts;
+  default_workload_options(&opts, 100000);
+  int opt;
+  int option_index = 0;
+  int ok = 1;
+  while ((opt = getopt_long_only(argc, argv, "", long_options,
+                                 &option_index)) != -1) {
+    switch (opt) {
+      case OPT_PRESET: {
+        int found = 0;
+        for (int i = 0; i < num_workload_presets; i++) {
+          if (strcmp(optarg, workload_presets[i].name) == 0) {
+            uint32_t lines = opts.lines;
+            uint64_t seed = opts.seed;
+            opts = workload_presets[i].opts;
+            opts.lines = lines;
+            opts.seed = seed;
+            found = 1;
+          }
+        }
+        ok = found;
+        break;
+      }
+      case OPT_LINES:
+        opts.lines = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case OPT_SEED:
+        opts.seed = strtoull(optarg, NULL, 10);
+        break;
+      case OPT_MIX:
+        ok = parse_workload_mix(&opts, optarg) == 0;
+        break;
+      case OPT_LABEL_DENSITY:
+        ok = parse_ratio(optarg, &opts.label_density) == 0;
+        break;
+      case OPT_FORWARD_RATIO:
+        ok = parse_ratio(optarg, &opts.forward_ratio) == 0;
+        break;
+      case OPT_PSEUDO_RATIO:
+        ok = parse_ratio(optarg, &opts.pseudo_ratio) == 0;
+        break;
+      case OPT_ERROR_RATE:
+        ok = parse_ratio(optarg, &opts.error_rate) == 0;
+        break;
+      default:
+        ok = 0;
+        break;
+    }
+    if (!ok) {
+      return usage(argv[0]);
+    }
+  }
+
+  size_t len;
+  uint32_t lines;
+  char* src = generate_workload(&opts, &len, &lines);
+  if (!src) {
+    fprintf(stderr, "Cannot generate the workload (empty mix or no memory).\n");
+    return 1;
+  }
+  int err = fwrite(src, 1, len, stdout) != len;
+  free(src);
+  return err;
+}
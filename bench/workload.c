@@ -0,0 +1,421 @@
+/* Synthetic RISC-V sources for the benchmarks; see workload.h. */
+
+#include "workload.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Label references stay within this many lines of the reference, so that
+   branches are in range even if every line expands to two instructions. */
+#define REF_WINDOW 500
+
+const WorkloadPreset workload_presets[] = {
+    /* A typical compiler-like program. */
+    {"mixed", {0, 1, {40, 25, 15, 12, 5, 3}, 0.05, 0.5, 0.10, 0.0}},
+    /* Straight-line arithmetic: no labels, no references. */
+    {"arith", {0, 1, {60, 40, 0, 0, 0, 0}, 0.0, 0.0, 0.0, 0.0}},
+    /* Many short basic blocks and branches, mostly forward. */
+    {"branchy", {0, 1, {20, 15, 10, 45, 10, 0}, 0.30, 0.8, 0.10, 0.0}},
+    /* Mostly pseudo-instructions. */
+    {"pseudo", {0, 1, {30, 20, 15, 20, 10, 5}, 0.05, 0.5, 0.80, 0.0}},
+    /* One line in ten is wrong; measures the diagnostic path. */
+    {"errors", {0, 1, {40, 25, 15, 12, 5, 3}, 0.05, 0.5, 0.10, 0.10}},
+};
+const int num_workload_presets =
+    (int)(sizeof(workload_presets) / sizeof(workload_presets[0]));
+
+static const char* mix_names[NUM_MIX_CLASSES] = {"r",      "i",    "mem",
+                                                 "branch", "jump", "upper"};
+
+static const char* const regs[] = {
+    "zero", "ra", "sp",  "gp",  "tp", "t0", "t1", "t2", "s0", "s1", "a0",
+    "a1",   "a2", "a3",  "a4",  "a5", "a6", "a7", "s2", "s3", "s4", "s5",
+    "s6",   "s7", "s8",  "s9",  "s10", "s11", "t3", "t4", "t5", "t6",
+    "fp",   "x0", "x1",  "x5",  "x10", "x17", "x28", "x31"};
+static const char* const r_ops[] = {"add", "sub", "xor", "or",   "and",
+                                    "sll", "srl", "sra", "slt",  "sltu",
+                                    "mul", "mulh", "div", "rem"};
+static const char* const i_ops[] = {"addi", "xori", "ori", "andi", "slti",
+                                    "sltiu"};
+static const char* const shift_ops[] = {"slli", "srli", "srai"};
+static const char* const load_ops[] = {"lb", "lh", "lw", "lbu", "lhu"};
+static const char* const store_ops[] = {"sb", "sh", "sw"};
+static const char* const branch_ops[] = {"beq", "bne",  "blt",
+                                         "bge", "bltu", "bgeu"};
+
+#define COUNT(array) (sizeof(array) / sizeof((array)[0]))
+
+/* Generator state. */
+typedef struct {
+  uint64_t rng;
+  char* buf;
+  size_t len;
+  size_t cap;
+  int oom;
+  /* Line indices (0-based instruction lines) that get a label, ascending. */
+  uint32_t* labels;
+  uint32_t num_labels;
+  uint32_t line;
+} Gen;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* splitmix64 */
+static uint64_t next(Gen* g) {
+  uint64_t z = (g->rng += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+static uint32_t below(Gen* g, uint32_t n) { return (uint32_t)(next(g) % n); }
+
+static int chance(Gen* g, double p) {
+  return (double)(next(g) >> 11) * (1.0 / 9007199254740992.0) < p;
+}
+
+static const char* pick(Gen* g, const char* const* list, size_t n) {
+  return list[below(g, (uint32_t)n)];
+}
+
+/* The emit_*() helpers draw one random value per call, so that the output
+   does not depend on the order in which a compiler evaluates arguments. */
+
+static void emit(Gen* g, const char* fmt, ...) {
+  if (g->oom) {
+    return;
+  }
+  for (;;) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(g->buf + g->len, g->cap - g->len, fmt, args);
+    va_end(args);
+    if (n >= 0 && (size_t)n < g->cap - g->len) {
+      g->len += (size_t)n;
+      return;
+    }
+    size_t cap = g->cap * 2 + 256;
+    char* buf = realloc(g->buf, cap);
+    if (!buf) {
+      g->oom = 1;
+      return;
+    }
+    g->buf = buf;
+    g->cap = cap;
+  }
+}
+
+/* Index of the first label at a line >= LINE. */
+static uint32_t first_label_from(const Gen* g, uint32_t line) {
+  uint32_t lo = 0, hi = g->num_labels;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (g->labels[mid] < line) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/* Picks a label within REF_WINDOW lines after (FORWARD) or before the
+   current line. Returns 0 and sets *TARGET, or -1 if there is none. */
+static int pick_label(Gen* g, int forward, uint32_t* target) {
+  uint32_t begin, end;
+  if (forward) {
+    begin = first_label_from(g, g->line + 1);
+    end = first_label_from(g, g->line + 1 + REF_WINDOW);
+  } else {
+    begin = first_label_from(
+        g, g->line > REF_WINDOW ? g->line - REF_WINDOW : 0);
+    end = first_label_from(g, g->line + 1);
+  }
+  if (begin == end) {
+    return -1;
+  }
+  *target = g->labels[begin + below(g, end - begin)];
+  return 0;
+}
+
+/* Appends " REG" for a random register. */
+static void emit_reg(Gen* g) { emit(g, " %s", pick(g, regs, COUNT(regs))); }
+
+/* Appends " IMM" for a random IMM in [LO, LO + SPAN). */
+static void emit_imm(Gen* g, int lo, uint32_t span) {
+  emit(g, " %d", lo + (int)below(g, span));
+}
+
+/* Appends " IMM(REG)" with a 12-bit signed IMM. */
+static void emit_mem_operand(Gen* g) {
+  emit_imm(g, -2048, 4096);
+  emit(g, "(%s)", pick(g, regs, COUNT(regs)));
+}
+
+/* Appends a branch or jump target and ends the line: a nearby label, or an
+   immediate offset if there is no label in reach. */
+static void emit_target(Gen* g, double forward_ratio) {
+  int forward = chance(g, forward_ratio);
+  uint32_t target;
+  if (pick_label(g, forward, &target) == 0 ||
+      pick_label(g, !forward, &target) == 0) {
+    emit(g, " L%u\n", target);
+  } else {
+    emit(g, " %d\n", ((int)below(g, 64) - 32) * 4);
+  }
+}
+
+static void emit_regular(Gen* g, const WorkloadOptions* opts, MixClass cls) {
+  switch (cls) {
+    case MIX_R:
+      emit(g, "%s", pick(g, r_ops, COUNT(r_ops)));
+      emit_reg(g);
+      emit_reg(g);
+      emit_reg(g);
+      break;
+    case MIX_I:
+      if (chance(g, 0.25)) {
+        emit(g, "%s", pick(g, shift_ops, COUNT(shift_ops)));
+        emit_reg(g);
+        emit_reg(g);
+        emit_imm(g, 0, 32);
+      } else {
+        emit(g, "%s", pick(g, i_ops, COUNT(i_ops)));
+        emit_reg(g);
+        emit_reg(g);
+        emit_imm(g, -2048, 4096);
+      }
+      break;
+    case MIX_MEM:
+      if (chance(g, 0.6)) {
+        emit(g, "%s", pick(g, load_ops, COUNT(load_ops)));
+      } else {
+        emit(g, "%s", pick(g, store_ops, COUNT(store_ops)));
+      }
+      emit_reg(g);
+      emit_mem_operand(g);
+      break;
+    case MIX_BRANCH:
+      emit(g, "%s", pick(g, branch_ops, COUNT(branch_ops)));
+      emit_reg(g);
+      emit_reg(g);
+      emit_target(g, opts->forward_ratio);
+      return;
+    case MIX_JUMP:
+      if (chance(g, 0.5)) {
+        emit(g, "jal");
+        emit_reg(g);
+        emit_target(g, opts->forward_ratio);
+        return;
+      }
+      emit(g, "jalr");
+      emit_reg(g);
+      emit_reg(g);
+      emit_imm(g, -2048, 4096);
+      break;
+    default:
+      emit(g, chance(g, 0.5) ? "lui" : "auipc");
+      emit_reg(g);
+      emit_imm(g, 0, 1u << 20);
+      break;
+  }
+  emit(g, "\n");
+}
+
+static void emit_pseudo(Gen* g, const WorkloadOptions* opts) {
+  uint32_t target;
+  int forward;
+  switch (below(g, 9)) {
+    case 0:
+    case 1:
+      emit(g, chance(g, 0.5) ? "beqz" : "bnez");
+      emit_reg(g);
+      emit_target(g, opts->forward_ratio);
+      return;
+    case 2:
+      emit(g, "li");
+      emit_reg(g);
+      /* Half of the constants need lui + addi. */
+      if (chance(g, 0.5)) {
+        emit_imm(g, -2048, 4096);
+      } else {
+        emit(g, " %d", (int32_t)(uint32_t)next(g));
+      }
+      break;
+    case 3:
+      emit(g, "mv");
+      emit_reg(g);
+      emit_reg(g);
+      break;
+    case 4:
+      emit(g, "j");
+      emit_target(g, opts->forward_ratio);
+      return;
+    case 5:
+      emit(g, "jr");
+      emit_reg(g);
+      break;
+    case 6:
+      emit(g, "jal");
+      emit_target(g, opts->forward_ratio);
+      return;
+    case 7:
+      emit(g, "jalr");
+      emit_reg(g);
+      break;
+    default:
+      emit(g, "lw");
+      emit_reg(g);
+      /* lw from a label has no immediate form. */
+      forward = chance(g, opts->forward_ratio);
+      if (pick_label(g, forward, &target) == 0 ||
+          pick_label(g, !forward, &target) == 0) {
+        emit(g, " L%u", target);
+      } else {
+        emit_mem_operand(g);
+      }
+      break;
+  }
+  emit(g, "\n");
+}
+
+static void emit_error(Gen* g) {
+  switch (below(g, 5)) {
+    case 0:
+      /* Unknown mnemonic. */
+      emit(g, "frob");
+      emit_reg(g);
+      emit_reg(g);
+      emit_reg(g);
+      break;
+    case 1:
+      /* Bad register. */
+      emit(g, "add");
+      emit_reg(g);
+      emit(g, " q%u", below(g, 32));
+      emit_reg(g);
+      break;
+    case 2:
+      /* Immediate out of range. */
+      emit(g, "addi");
+      emit_reg(g);
+      emit_reg(g);
+      emit_imm(g, 4096, 4096);
+      break;
+    case 3:
+      /* Extra argument. */
+      emit(g, "sub");
+      emit_reg(g);
+      emit_reg(g);
+      emit_reg(g);
+      emit_reg(g);
+      break;
+    default:
+      /* Undefined label. */
+      emit(g, "beq");
+      emit_reg(g);
+      emit_reg(g);
+      emit(g, " missing_%u", g->line);
+      break;
+  }
+  emit(g, "\n");
+}
+
+/*******************************
+ * Workload Functions
+ *******************************/
+
+void default_workload_options(WorkloadOptions* opts, uint32_t lines) {
+  *opts = workload_presets[0].opts;
+  opts->lines = lines;
+}
+
+int parse_workload_mix(WorkloadOptions* opts, const char* spec) {
+  unsigned mix[NUM_MIX_CLASSES] = {0};
+  const char* p = spec;
+  while (*p) {
+    int cls = -1;
+    for (int i = 0; i < NUM_MIX_CLASSES; i++) {
+      size_t n = strlen(mix_names[i]);
+      if (strncmp(p, mix_names[i], n) == 0 && p[n] == '=') {
+        cls = i;
+        p += n + 1;
+        break;
+      }
+    }
+    char* end;
+    unsigned long weight = strtoul(p, &end, 10);
+    if (cls < 0 || end == p || (*end != ',' && *end != '\0')) {
+      return -1;
+    }
+    mix[cls] = (unsigned)weight;
+    p = *end ? end + 1 : end;
+  }
+  memcpy(opts->mix, mix, sizeof(mix));
+  return 0;
+}
+
+char* generate_workload(const WorkloadOptions* opts, size_t* len,
+                        uint32_t* num_lines) {
+  Gen g = {0};
+  g.rng = opts->seed;
+  unsigned total_weight = 0;
+  for (int i = 0; i < NUM_MIX_CLASSES; i++) {
+    total_weight += opts->mix[i];
+  }
+  if (total_weight == 0) {
+    return NULL;
+  }
+
+  /* Decide up front which lines get labels, so that forward references
+     know their targets. */
+  g.labels = malloc(((size_t)opts->lines + 1) * sizeof(uint32_t));
+  g.cap = (size_t)opts->lines * 24 + 256;
+  g.buf = malloc(g.cap);
+  if (!g.labels || !g.buf) {
+    free(g.labels);
+    free(g.buf);
+    return NULL;
+  }
+  for (uint32_t i = 0; i < opts->lines; i++) {
+    if (chance(&g, opts->label_density)) {
+      g.labels[g.num_labels++] = i;
+    }
+  }
+
+  uint32_t lines = 0;
+  uint32_t next_label = 0;
+  for (g.line = 0; g.line < opts->lines; g.line++) {
+    if (next_label < g.num_labels && g.labels[next_label] == g.line) {
+      emit(&g, "L%u:\n", g.line);
+      next_label++;
+      lines++;
+    }
+    if (chance(&g, opts->error_rate)) {
+      emit_error(&g);
+    } else if (chance(&g, opts->pseudo_ratio)) {
+      emit_pseudo(&g, opts);
+    } else {
+      unsigned w = below(&g, total_weight);
+      int cls = 0;
+      while (w >= opts->mix[cls]) {
+        w -= opts->mix[cls++];
+      }
+      emit_regular(&g, opts, (MixClass)cls);
+    }
+    lines++;
+  }
+
+  free(g.labels);
+  if (g.oom) {
+    free(g.buf);
+    return NULL;
+  }
+  *len = g.len;
+  *num_lines = lines;
+  return g.buf;
+}
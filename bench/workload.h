@@ -0,0 +1,69 @@
+/* Synthetic RISC-V sources for the benchmarks.
+
+   generate_workload() writes a program of a given number of instruction
+   lines in the dialect of the tests in test/in. The output depends only on
+   the options (the random generator is seeded from SEED), so a workload is
+   the same on every machine and every run, and throughput numbers can be
+   compared across versions.
+*/
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Instruction classes of the mix. */
+typedef enum {
+  MIX_R,      /* add, sub, mul, ... */
+  MIX_I,      /* addi, slli, ... */
+  MIX_MEM,    /* loads and stores */
+  MIX_BRANCH, /* beq, bne, ... to a label */
+  MIX_JUMP,   /* jal to a label, jalr */
+  MIX_UPPER,  /* lui, auipc */
+  NUM_MIX_CLASSES,
+} MixClass;
+
+typedef struct {
+  /* Number of instruction lines (labels, blank lines and errors are extra
+     or included as noted below). */
+  uint32_t lines;
+  uint64_t seed;
+  /* Relative weights of the instruction classes. */
+  unsigned mix[NUM_MIX_CLASSES];
+  /* Probability that an instruction line is preceded by a label. */
+  double label_density;
+  /* Share of label references that point to a later label. */
+  double forward_ratio;
+  /* Share of instruction lines written as a pseudo-instruction (beqz, li,
+     mv, j, ...). */
+  double pseudo_ratio;
+  /* Share of instruction lines replaced by an erroneous one (unknown
+     mnemonic, bad register, immediate out of range, extra argument, or
+     undefined label). */
+  double error_rate;
+} WorkloadOptions;
+
+/* Named presets, for the benchmark and gen_workload --preset. */
+typedef struct {
+  const char* name;
+  WorkloadOptions opts;
+} WorkloadPreset;
+
+extern const WorkloadPreset workload_presets[];
+extern const int num_workload_presets;
+
+/* Fills OPTS with the "mixed" preset and LINES lines. */
+void default_workload_options(WorkloadOptions* opts, uint32_t lines);
+
+/* Parses a mix such as "r=40,i=30,mem=15,branch=10,jump=3,upper=2" into
+   OPTS->mix; classes that are not named get weight 0. Returns -1 if SPEC
+   is malformed. */
+int parse_workload_mix(WorkloadOptions* opts, const char* spec);
+
+/* Returns a malloc'd source for OPTS, and its size in *LEN and number of
+   source lines in *NUM_LINES. Returns NULL if memory runs out. */
+char* generate_workload(const WorkloadOptions* opts, size_t* len,
+                        uint32_t* num_lines);
+
+#endif
@@ -0,0 +1,145 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+/* Initial number of slots in the intern set. Must be a power of two. */
+#define INITIAL_INTERN_CAP 64
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Returns the intern slot holding STR, or the empty slot where STR would be
+   inserted. */
+static char** find_interned(StrArena* arena, const char* str) {
+  uint32_t mask = arena->interned_cap - 1;
+  uint32_t pos = hash_string(str) & mask;
+  while (arena->interned[pos] && strcmp(arena->interned[pos], str) != 0) {
+    pos = (pos + 1) & mask;
+  }
+  return &arena->interned[pos];
+}
+
+/* Double the intern set (or create it). Returns -1 on allocation failure. */
+static int grow_interned(StrArena* arena) {
+  char** old = arena->interned;
+  uint32_t old_cap = arena->interned_cap;
+  uint32_t new_cap = old_cap ? old_cap * 2 : INITIAL_INTERN_CAP;
+  char** slots = calloc(new_cap, sizeof(char*));
+  if (!slots) {
+    return -1;
+  }
+  arena->interned = slots;
+  arena->interned_cap = new_cap;
+  for (uint32_t i = 0; i < old_cap; i++) {
+    if (old[i]) {
+      *find_interned(arena, old[i]) = old[i];
+    }
+  }
+  free(old);
+  return 0;
+}
+
+/*******************************
+ * Arena Functions
+ *******************************/
+
+void arena_init(StrArena* arena) {
+  arena->head = NULL;
+  arena->interned = NULL;
+  arena->interned_cap = 0;
+  arena->interned_len = 0;
+  arena->bytes_used = 0;
+}
+
+void arena_release(StrArena* arena) {
+  ArenaChunk* chunk = arena->head;
+  while (chunk) {
+    ArenaChunk* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  free(arena->interned);
+  arena_init(arena);
+}
+
+void arena_reset(StrArena* arena) {
+  ArenaChunk* head = arena->head;
+  if (!head) {
+    return;
+  }
+  ArenaChunk* chunk = head->next;
+  while (chunk) {
+    ArenaChunk* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  head->next = NULL;
+  head->used = 0;
+  if (arena->interned) {
+    memset(arena->interned, 0, arena->interned_cap * sizeof(char*));
+  }
+  arena->interned_len = 0;
+  arena->bytes_used = 0;
+}
+
+char* arena_alloc(StrArena* arena, size_t size) {
+  ArenaChunk* chunk = arena->head;
+  if (!chunk || chunk->cap - chunk->used < size) {
+    size_t cap = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+    chunk = malloc(sizeof(ArenaChunk) + cap);
+    if (!chunk) {
+      return NULL;
+    }
+    chunk->cap = cap;
+    chunk->used = 0;
+    /* An oversized chunk is full right away; keep filling the current one. */
+    if (arena->head && cap > ARENA_CHUNK_SIZE) {
+      chunk->next = arena->head->next;
+      arena->head->next = chunk;
+    } else {
+      chunk->next = arena->head;
+      arena->head = chunk;
+    }
+  }
+  char* ptr = chunk->data + chunk->used;
+  chunk->used += size;
+  arena->bytes_used += size;
+  return ptr;
+}
+
+char* arena_strdup(StrArena* arena, const char* str) {
+  size_t len = strlen(str);
+  char* dst = arena_alloc(arena, len + 1);
+  if (dst) {
+    memcpy(dst, str, len + 1);
+  }
+  return dst;
+}
+
+char* arena_intern(StrArena* arena, const char* str) {
+  /* Keep the intern set at most half full. */
+  if ((arena->interned_len + 1) * 2 > arena->interned_cap &&
+      grow_interned(arena) != 0) {
+    return NULL;
+  }
+  char** slot = find_interned(arena, str);
+  if (!*slot) {
+    *slot = arena_strdup(arena, str);
+    if (!*slot) {
+      return NULL;
+    }
+    arena->interned_len++;
+  }
+  return *slot;
+}
@@ -0,0 +1,68 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Default size of an arena chunk. Strings longer than this get a chunk of
+   their own. */
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+/* A chunk of arena memory. Chunks form a singly linked list, newest first. */
+typedef struct ArenaChunk {
+  struct ArenaChunk* next;
+  size_t cap;
+  size_t used;
+  char data[];
+} ArenaChunk;
+
+/* A bump-pointer string arena. Strings are never freed individually; the
+   whole arena is released at once with arena_release().
+
+   The arena can also intern strings: interned strings with the same contents
+   share one copy. The intern set is an open-addressing hash table of pointers
+   into the arena.
+ */
+typedef struct {
+  /* Chunk currently being filled. */
+  ArenaChunk* head;
+
+  /* Intern set. Each slot is NULL or an interned string. */
+  char** interned;
+  /* Number of slots in `interned`, 0 or a power of two. */
+  uint32_t interned_cap;
+  /* Number of occupied slots in `interned`. */
+  uint32_t interned_len;
+
+  /* Total bytes handed out by arena_alloc(). */
+  size_t bytes_used;
+} StrArena;
+
+/* Initialize an empty arena. No memory is allocated until first use. */
+void arena_init(StrArena* arena);
+
+/* Release every chunk and the intern set. The arena is empty afterwards and
+   may be reused. */
+void arena_release(StrArena* arena);
+
+/* Drop every string but keep the current chunk for reuse, so that an arena
+   that is emptied over and over does not go back to malloc(). */
+void arena_reset(StrArena* arena);
+
+/* Allocate SIZE bytes from the arena. Returns NULL on allocation failure. */
+char* arena_alloc(StrArena* arena, size_t size);
+
+/* Copy STR into the arena. Returns NULL on allocation failure. */
+char* arena_strdup(StrArena* arena, const char* str);
+
+/* Return the arena copy of STR, copying it on first use only. Returns NULL on
+   allocation failure. */
+char* arena_intern(StrArena* arena, const char* str);
+
+#endif
@@ -0,0 +1,337 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "backpatch.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "translate_utils.h"
+#include "utils.h"
+
+/* States of a word slot. */
+enum { SLOT_READY, SLOT_PENDING, SLOT_DROPPED };
+
+/* Initial number of pending-label buckets. Must be a power of two. */
+#define INITIAL_BUCKETS 64
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Copies NAME and ARGS, NUL-separated, to DST. */
+static void pack_text(char* dst, const char* name, char* const* args,
+                      uint32_t arg_num) {
+  size_t len = strlen(name) + 1;
+  memcpy(dst, name, len);
+  dst += len;
+  for (uint32_t i = 0; i < arg_num; i++) {
+    len = strlen(args[i]) + 1;
+    memcpy(dst, args[i], len);
+    dst += len;
+  }
+}
+
+static size_t text_size(const char* name, char* const* args,
+                        uint32_t arg_num) {
+  size_t size = strlen(name) + 1;
+  for (uint32_t i = 0; i < arg_num; i++) {
+    size += strlen(args[i]) + 1;
+  }
+  return size;
+}
+
+/* Records that instruction INDEX could not be encoded. The source text is
+   copied since the caller's strings do not outlive the current line. */
+static void add_failure(Backpatcher* bp, uint32_t index, int line_number,
+                        const char* name, char* const* args,
+                        uint32_t arg_num) {
+  if (bp->num_failures == bp->failures_cap) {
+    uint32_t new_cap =
+        bp->failures_cap ? bp->failures_cap * 2 : INCREMENT_OF_CAP;
+    EncodeFailure* failures =
+        realloc(bp->failures, new_cap * sizeof(EncodeFailure));
+    if (!failures) {
+      allocation_failed();
+    }
+    bp->failures = failures;
+    bp->failures_cap = new_cap;
+  }
+  char* text = malloc(text_size(name, args, arg_num));
+  if (!text) {
+    allocation_failed();
+  }
+  pack_text(text, name, args, arg_num);
+
+  EncodeFailure* failure = &bp->failures[bp->num_failures++];
+  failure->index = index;
+  failure->line_number = line_number;
+  failure->arg_num = arg_num;
+  failure->name = text;
+  text += strlen(text) + 1;
+  for (uint32_t i = 0; i < arg_num; i++) {
+    failure->args[i] = text;
+    text += strlen(text) + 1;
+  }
+}
+
+/* Records the failure of a deferred instruction from its fixup. */
+static void fail_fixup(Backpatcher* bp, const Fixup* fixup) {
+  char* args[MAX_ARGS];
+  const char* name = fixup->text;
+  const char* text = name + strlen(name) + 1;
+  for (uint32_t i = 0; i < fixup->arg_num; i++) {
+    args[i] = (char*)text;
+    text += strlen(text) + 1;
+  }
+  add_failure(bp, fixup->index, fixup->line_number, name, args,
+              fixup->arg_num);
+}
+
+/* Writes out the words in front of the oldest unresolved instruction. */
+static void flush_ready(Backpatcher* bp) {
+  while (bp->head < bp->len && bp->states[bp->head] != SLOT_PENDING) {
+    if (bp->states[bp->head] == SLOT_READY) {
+      write_inst(bp->output, bp->words[bp->head]);
+    }
+    bp->head++;
+  }
+  if (bp->head == bp->len) {
+    bp->base += bp->len;
+    bp->head = 0;
+    bp->len = 0;
+  }
+}
+
+/* Appends a slot for the next instruction and returns its position. */
+static uint32_t push_slot(Backpatcher* bp) {
+  if (bp->len == bp->cap) {
+    if (bp->head > 0) {
+      /* Slide the unwritten words to the front before growing. */
+      uint32_t live = bp->len - bp->head;
+      memmove(bp->words, bp->words + bp->head, live * sizeof(uint32_t));
+      memmove(bp->states, bp->states + bp->head, live);
+      bp->base += bp->head;
+      bp->len = live;
+      bp->head = 0;
+    }
+    if (bp->len == bp->cap) {
+      uint32_t new_cap = bp->cap ? bp->cap * 2 : INCREMENT_OF_CAP;
+      uint32_t* words = realloc(bp->words, new_cap * sizeof(uint32_t));
+      if (!words) {
+        allocation_failed();
+      }
+      bp->words = words;
+      uint8_t* states = realloc(bp->states, new_cap);
+      if (!states) {
+        allocation_failed();
+      }
+      bp->states = states;
+      bp->cap = new_cap;
+    }
+  }
+  return bp->len++;
+}
+
+/* Returns the bucket slot holding the pending label NAME, or the NULL link
+   at the end of its chain. */
+static PendingLabel** find_pending(Backpatcher* bp, const char* name) {
+  PendingLabel** link =
+      &bp->buckets[hash_string(name) & (bp->num_buckets - 1)];
+  while (*link && strcmp((*link)->name, name) != 0) {
+    link = &(*link)->next;
+  }
+  return link;
+}
+
+/* Doubles the number of buckets, keeping them at most one label each on
+   average. */
+static void grow_buckets(Backpatcher* bp) {
+  uint32_t old_num = bp->num_buckets;
+  PendingLabel** old = bp->buckets;
+  bp->num_buckets = old_num ? old_num * 2 : INITIAL_BUCKETS;
+  bp->buckets = calloc(bp->num_buckets, sizeof(PendingLabel*));
+  if (!bp->buckets) {
+    allocation_failed();
+  }
+  for (uint32_t i = 0; i < old_num; i++) {
+    PendingLabel* label = old[i];
+    while (label) {
+      PendingLabel* next = label->next;
+      PendingLabel** link = find_pending(bp, label->name);
+      label->next = *link;
+      *link = label;
+      label = next;
+    }
+  }
+  free(old);
+}
+
+/* Defers INST, which is instruction INDEX, until LABEL is defined. */
+static void add_fixup(Backpatcher* bp, const Instr* inst, const IrInstr* ir,
+                      uint32_t index, const char* label) {
+  if (bp->num_pending + 1 > bp->num_buckets) {
+    grow_buckets(bp);
+  }
+  PendingLabel** link = find_pending(bp, label);
+  if (!*link) {
+    size_t len = strlen(label) + 1;
+    PendingLabel* pending = malloc(sizeof(PendingLabel) + len);
+    if (!pending) {
+      allocation_failed();
+    }
+    memcpy(pending->name, label, len);
+    pending->fixups = NULL;
+    pending->next = NULL;
+    *link = pending;
+    bp->num_pending++;
+  }
+
+  Fixup* fixup = malloc(sizeof(Fixup) +
+                        text_size(inst->name, inst->args, inst->arg_num));
+  if (!fixup) {
+    allocation_failed();
+  }
+  pack_text(fixup->text, inst->name, inst->args, inst->arg_num);
+  fixup->ir = *ir;
+  fixup->index = index;
+  fixup->line_number = inst->line_number;
+  fixup->arg_num = inst->arg_num;
+  fixup->next = (*link)->fixups;
+  (*link)->fixups = fixup;
+}
+
+static int compare_failures(const void* a, const void* b) {
+  uint32_t x = ((const EncodeFailure*)a)->index;
+  uint32_t y = ((const EncodeFailure*)b)->index;
+  return (x > y) - (x < y);
+}
+
+/*******************************
+ * Backpatching Functions
+ *******************************/
+
+void backpatch_init(Backpatcher* bp, OutputWriter* output) {
+  memset(bp, 0, sizeof(*bp));
+  bp->output = output;
+}
+
+void backpatch_release(Backpatcher* bp) {
+  for (uint32_t i = 0; i < bp->num_buckets; i++) {
+    PendingLabel* label = bp->buckets[i];
+    while (label) {
+      PendingLabel* next = label->next;
+      Fixup* fixup = label->fixups;
+      while (fixup) {
+        Fixup* next_fixup = fixup->next;
+        free(fixup);
+        fixup = next_fixup;
+      }
+      free(label);
+      label = next;
+    }
+  }
+  for (uint32_t i = 0; i < bp->num_failures; i++) {
+    free(bp->failures[i].name);
+  }
+  free(bp->buckets);
+  free(bp->failures);
+  free(bp->words);
+  free(bp->states);
+  memset(bp, 0, sizeof(*bp));
+}
+
+void backpatch_add(Backpatcher* bp, Instr* inst, SymbolTable* table) {
+  uint32_t index = bp->next_index++;
+  uint32_t slot = push_slot(bp);
+  IrInstr ir;
+  const char* label;
+
+  bp->states[slot] = SLOT_DROPPED;
+  if (decode_inst(&ir, &label, inst->name, inst->args, inst->arg_num) != 0) {
+    add_failure(bp, index, inst->line_number, inst->name, inst->args,
+                inst->arg_num);
+    flush_ready(bp);
+    return;
+  }
+  int64_t label_addr = 0;
+  if (label) {
+    label_addr = get_addr_for_symbol(table, label);
+    if (label_addr == -1) {
+      bp->states[slot] = SLOT_PENDING;
+      add_fixup(bp, inst, &ir, index, label);
+      return;
+    }
+  }
+  if (encode_inst(&ir, index * 4, label_addr, &bp->words[slot]) == 0) {
+    bp->states[slot] = SLOT_READY;
+  } else {
+    add_failure(bp, index, inst->line_number, inst->name, inst->args,
+                inst->arg_num);
+  }
+  flush_ready(bp);
+}
+
+void backpatch_define(Backpatcher* bp, const char* label, uint32_t addr) {
+  if (bp->num_pending == 0) {
+    return;
+  }
+  PendingLabel** link = find_pending(bp, label);
+  PendingLabel* pending = *link;
+  if (!pending) {
+    return;
+  }
+  *link = pending->next;
+  bp->num_pending--;
+
+  Fixup* fixup = pending->fixups;
+  while (fixup) {
+    Fixup* next = fixup->next;
+    uint32_t slot = fixup->index - bp->base;
+    if (encode_inst(&fixup->ir, fixup->index * 4, addr, &bp->words[slot]) ==
+        0) {
+      bp->states[slot] = SLOT_READY;
+    } else {
+      bp->states[slot] = SLOT_DROPPED;
+      fail_fixup(bp, fixup);
+    }
+    free(fixup);
+    fixup = next;
+  }
+  free(pending);
+  flush_ready(bp);
+}
+
+int backpatch_finish(Backpatcher* bp) {
+  /* Whatever is still pending refers to a label that was never defined. */
+  for (uint32_t i = 0; i < bp->num_buckets; i++) {
+    PendingLabel* label = bp->buckets[i];
+    while (label) {
+      PendingLabel* next = label->next;
+      Fixup* fixup = label->fixups;
+      while (fixup) {
+        Fixup* next_fixup = fixup->next;
+        bp->states[fixup->index - bp->base] = SLOT_DROPPED;
+        fail_fixup(bp, fixup);
+        free(fixup);
+        fixup = next_fixup;
+      }
+      free(label);
+      label = next;
+    }
+    bp->buckets[i] = NULL;
+  }
+  bp->num_pending = 0;
+  flush_ready(bp);
+
+  /* FAILURES is NULL while nothing has failed. */
+  if (bp->num_failures > 1) {
+    qsort(bp->failures, bp->num_failures, sizeof(EncodeFailure),
+          compare_failures);
+  }
+  return bp->num_failures ? -1 : 0;
+}
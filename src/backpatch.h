@@ -0,0 +1,102 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef BACKPATCH_H
+#define BACKPATCH_H
+
+#include <stdint.h>
+
+#include "block.h"
+#include "tables.h"
+#include "translate.h"
+#include "writer.h"
+
+/* An instruction waiting for a label that is not defined yet. Its source
+   text is kept in TEXT (name and arguments, NUL-separated) for the
+   diagnostic in case the label never shows up. */
+typedef struct Fixup {
+  struct Fixup* next;
+  IrInstr ir;
+  uint32_t index;
+  int line_number;
+  uint32_t arg_num;
+  char text[];
+} Fixup;
+
+/* All fixups waiting for one label. */
+typedef struct PendingLabel {
+  struct PendingLabel* next;
+  Fixup* fixups;
+  char name[];
+} PendingLabel;
+
+/* An instruction that could not be encoded; reported by the caller. */
+typedef struct {
+  uint32_t index;
+  int line_number;
+  char* name;
+  char* args[MAX_ARGS];
+  uint32_t arg_num;
+} EncodeFailure;
+
+/* Single-pass encoder.
+
+   Instructions are numbered in the order they are added; instruction I
+   lives at byte offset 4 * I. Each one is encoded right away unless it
+   refers to a label that is not in the symbol table yet. In that case a
+   fixup is recorded under the label's name, and its word is patched in place
+   once backpatch_define() announces the label.
+
+   Encoded words are handed to OUTPUT as soon as no unresolved instruction
+   precedes them, so the words held in memory only span from the oldest
+   unresolved instruction to the newest one.
+ */
+typedef struct {
+  OutputWriter* output;
+
+  /* Instruction index of the next instruction to be added. */
+  uint32_t next_index;
+
+  /* Words of instructions [base + head, base + len) not yet written to
+     OUTPUT, with one SLOT_* state each. */
+  uint32_t* words;
+  uint8_t* states;
+  uint32_t base;
+  uint32_t head;
+  uint32_t len;
+  uint32_t cap;
+
+  /* Pending labels, chained hash table. */
+  PendingLabel** buckets;
+  uint32_t num_buckets;
+  uint32_t num_pending;
+
+  /* Instructions that failed to encode, in the order they failed. */
+  EncodeFailure* failures;
+  uint32_t num_failures;
+  uint32_t failures_cap;
+} Backpatcher;
+
+/* Initialize BP to write encoded instructions to OUTPUT. */
+void backpatch_init(Backpatcher* bp, OutputWriter* output);
+
+/* Free all memory held by BP. */
+void backpatch_release(Backpatcher* bp);
+
+/* Add INST as the next instruction. It is encoded now if it needs no label
+   or its label is already in TABLE, and deferred otherwise. */
+void backpatch_add(Backpatcher* bp, Instr* inst, SymbolTable* table);
+
+/* Patch every instruction waiting for LABEL, which was just defined at byte
+   offset ADDR. */
+void backpatch_define(Backpatcher* bp, const char* label, uint32_t addr);
+
+/* Fail every instruction still waiting for a label and write the remaining
+   words. Afterwards bp->failures holds every instruction that could not be
+   encoded, sorted by index. Returns -1 if there are any. */
+int backpatch_finish(Backpatcher* bp);
+
+#endif
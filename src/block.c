@@ -29,6 +29,7 @@ extern const uint32_t MAX_ADDR;
 /* Helper function for handling block allocation failure */
 void block_allocation_failed(void) {
   write_to_log("Error: allocation failed\n");
+  recover_from_allocation_failure();
   exit(1);
 }
 
@@ -49,14 +50,23 @@ void block_write_inst(FILE* output, Instr* entry) {
    The line number is initialized to 1.
  */
 Block* create_block(void) {
+  return create_block_with_capacity(INCREMENT_OF_CAP);
+}
+
+/* Like create_block(), but reserves room for CAP instructions up front so a
+   caller that knows the input size can avoid repeated resize_block() calls.
+   CAP is a hint; the block still grows past it as needed.
+ */
+Block* create_block_with_capacity(uint32_t cap) {
   Block* block = (Block*)malloc(sizeof(Block));
   if (!block) {
     block_allocation_failed();
   }
   block->len = 0;
-  block->cap = INCREMENT_OF_CAP;
+  block->cap = cap > INCREMENT_OF_CAP ? cap : INCREMENT_OF_CAP;
   block->entries = (Instr*)malloc(block->cap * sizeof(Instr));
   block->line_number = 1;
+  arena_init(&block->strings);
   if (!block->entries) {
     free(block);
     block_allocation_failed();
@@ -70,32 +80,15 @@ void free_block(Block* block) {
   if (!block) {
     return;
   }
-  for (uint32_t i = 0; i < block->len; i++) {
-    free(block->entries[i].name);
-    for (uint32_t j = 0; j < block->entries[i].arg_num; j++) {
-      free(block->entries[i].args[j]);
-    }
-  }
+  /* Names and arguments all live in the arena. */
+  arena_release(&block->strings);
   free(block->entries);
   free(block);
 }
 
-/* Helper function to copy a string. */
-static char* strdup(const char* src) {
-  if (!src) {
-    return NULL;
-  }
-  size_t len = strlen(src);
-  char* dst = (char*)malloc(len + 1);
-  if (!dst) {
-    block_allocation_failed();
-  }
-  strcpy(dst, src);
-  return dst;
-}
-
 /* Add a new Instr to the Block pointed to by 'block'.
-   Restore the entry's line number. */
+   Restore the entry's line number. The name is interned in the block's
+   string arena; arguments are copied there too. */
 int add_to_block(Block* block, const char* name, char** args,
                  uint32_t arg_num) {
   if (!block || !name || !args) {
@@ -107,15 +100,27 @@ int add_to_block(Block* block, const char* name, char** args,
   }
   Instr* entry = &block->entries[block->len];
   entry->line_number = block->line_number;
-  entry->name = strdup(name);
+  entry->name = arena_intern(&block->strings, name);
+  if (!entry->name) {
+    block_allocation_failed();
+  }
   entry->arg_num = arg_num;
   for (uint32_t i = 0; i < arg_num; ++i) {
-    entry->args[i] = strdup(args[i]);
+    entry->args[i] = arena_strdup(&block->strings, args[i]);
+    if (!entry->args[i]) {
+      block_allocation_failed();
+    }
   }
   block->len++;
   return 0;
 }
 
+/* Drop all entries and the strings they own. */
+void block_clear(Block* block) {
+  block->len = 0;
+  arena_reset(&block->strings);
+}
+
 /* Write the contents of the block to the output file */
 void write_block(Block* block, FILE* output) {
   if (!block || !output) {
@@ -128,13 +133,18 @@ void write_block(Block* block, FILE* output) {
   }
 }
 
-/* Increase the capacity of the block by INCREMENT_OF_CAP */
+/* Double the capacity of the block, growing by at least INCREMENT_OF_CAP.
+   Geometric growth keeps the total copying done by realloc() linear in the
+   number of instructions. */
 void resize_block(Block* block) {
-  Instr* new_entries =
-      realloc(block->entries, (block->len + INCREMENT_OF_CAP) * sizeof(Instr));
+  uint32_t new_cap = block->cap * 2;
+  if (new_cap < block->cap + INCREMENT_OF_CAP) {
+    new_cap = block->cap + INCREMENT_OF_CAP;
+  }
+  Instr* new_entries = realloc(block->entries, new_cap * sizeof(Instr));
   if (!new_entries) {
     block_allocation_failed();
   }
   block->entries = new_entries;
-  block->cap = block->len + INCREMENT_OF_CAP;
+  block->cap = new_cap;
 }
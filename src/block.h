@@ -10,8 +10,10 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "arena.h"
+
 #define MAX_ARGS 3
-/* increment of capacity */
+/* initial capacity, and the minimum growth step */
 #define INCREMENT_OF_CAP 32
 
 /* The `Instr` structure represents an instruction. It stores the instruction
@@ -88,6 +90,10 @@ typedef struct {
 
   /* The line number in the source file where the block is defined */
   uint32_t line_number;
+
+  /* Storage for every instruction name and argument in `entries`. Names are
+     interned, so all entries with the same mnemonic share one string. */
+  StrArena strings;
 } Block;
 
 /* Helper function for handling block allocation failure */
@@ -96,15 +102,22 @@ void block_allocation_failed(void);
 /* Create and initialize a new block */
 Block* create_block();
 
+/* Create a new block with room for CAP instructions before it has to grow */
+Block* create_block_with_capacity(uint32_t cap);
+
 /* Free a previously allocated block */
 void free_block(Block* block);
 
-/* Increase the capacity of the block by INCREMENT_OF_CAP */
+/* Double the capacity of the block (by at least INCREMENT_OF_CAP) */
 void resize_block(Block* block);
 
 /* Add an instruction to the given block */
 int add_to_block(Block* block, const char* name, char** args, uint32_t arg_num);
 
+/* Remove every instruction but keep the allocated memory, so the block can
+   be refilled (e.g. once per source line) without growing */
+void block_clear(Block* block);
+
 /* Write the contents of the block to the output file */
 void write_block(Block* block, FILE* output);
 
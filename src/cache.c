@@ -0,0 +1,363 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* First bytes of a cache file. Bump the digit whenever the layout below or
+   the encoding of any instruction changes, so that old files are ignored. */
+#define CACHE_MAGIC "RVCACHE1"
+#define CACHE_MAGIC_LEN 8
+
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+/* A cache file is the magic, a FileHeader and then, for each record, a
+   RecordHeader followed by its words, defs, uses and names. Every part
+   starts at a multiple of 8 bytes, so that the records can point into the
+   file's contents as they are. */
+typedef struct {
+  uint32_t num_records;
+  /* sizeof(ChunkUse), which depends on IrInstr. */
+  uint32_t use_size;
+} FileHeader;
+
+typedef struct {
+  uint64_t hash;
+  uint64_t len;
+  uint32_t num_lines;
+  uint32_t num_words;
+  uint32_t num_defs;
+  uint32_t num_uses;
+  uint32_t names_len;
+  uint32_t reserved;
+} RecordHeader;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+static size_t pad8(size_t size) { return (size + 7) & ~(size_t)7; }
+
+/* Sizes of the parts of a record, padded. */
+static size_t words_size(uint32_t n) { return pad8((size_t)n * 4); }
+static size_t defs_size(uint32_t n) { return (size_t)n * sizeof(ChunkDef); }
+static size_t uses_size(uint32_t n) {
+  return pad8((size_t)n * sizeof(ChunkUse));
+}
+static size_t names_size(uint32_t n) { return pad8(n); }
+
+/* Points the arrays of RECORD at consecutive parts of MEM. */
+static void lay_out_record(ChunkRecord* record, char* mem) {
+  record->words = (uint32_t*)mem;
+  mem += words_size(record->num_words);
+  record->defs = (ChunkDef*)mem;
+  mem += defs_size(record->num_defs);
+  record->uses = (ChunkUse*)mem;
+  mem += uses_size(record->num_uses);
+  record->names = mem;
+}
+
+/* Checks that the record read from a file only refers to its own names and
+   words and only holds instructions that encode_inst() knows. */
+static int record_is_valid(const ChunkRecord* record) {
+  if (record->names_len > 0 && record->names[record->names_len - 1] != '\0') {
+    return 0;
+  }
+  for (uint32_t i = 0; i < record->num_defs; i++) {
+    if (record->defs[i].name >= record->names_len ||
+        record->defs[i].offset > record->num_words * 4) {
+      return 0;
+    }
+  }
+  for (uint32_t i = 0; i < record->num_uses; i++) {
+    const ChunkUse* use = &record->uses[i];
+    if (use->name >= record->names_len || use->index >= record->num_words ||
+        use->ir.op >= NUM_INSTRS || use->ir.sym == IR_NO_SYMBOL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Reads the whole file at PATH into a malloc'd buffer. */
+static char* read_file(const char* path, size_t* len) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  char* data = NULL;
+  long size;
+  if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 &&
+      fseek(file, 0, SEEK_SET) == 0 && (data = malloc((size_t)size))) {
+    if (fread(data, 1, (size_t)size, file) != (size_t)size) {
+      free(data);
+      data = NULL;
+    }
+    *len = (size_t)size;
+  }
+  fclose(file);
+  return data;
+}
+
+/* Parses DATA into CACHE->records. Returns -1 if the file is malformed. */
+static int parse_cache(ChunkCache* cache, char* data, size_t len) {
+  FileHeader header;
+  size_t pos = CACHE_MAGIC_LEN + sizeof(header);
+  if (len < pos || memcmp(data, CACHE_MAGIC, CACHE_MAGIC_LEN) != 0) {
+    return -1;
+  }
+  memcpy(&header, data + CACHE_MAGIC_LEN, sizeof(header));
+  if (header.use_size != sizeof(ChunkUse) ||
+      header.num_records > (len - pos) / sizeof(RecordHeader)) {
+    return -1;
+  }
+  cache->records = malloc((header.num_records + 1) * sizeof(ChunkRecord));
+  if (!cache->records) {
+    return -1;
+  }
+  for (uint32_t i = 0; i < header.num_records; i++) {
+    RecordHeader rh;
+    if (len - pos < sizeof(rh)) {
+      return -1;
+    }
+    memcpy(&rh, data + pos, sizeof(rh));
+    pos += sizeof(rh);
+    /* Each part is bounded by 2^32 entries, so the sum cannot overflow. */
+    size_t body = words_size(rh.num_words) + defs_size(rh.num_defs) +
+                  uses_size(rh.num_uses) + names_size(rh.names_len);
+    if (len - pos < body) {
+      return -1;
+    }
+    ChunkRecord* record = &cache->records[cache->len];
+    record->hash = rh.hash;
+    record->len = rh.len;
+    record->num_lines = rh.num_lines;
+    record->num_words = rh.num_words;
+    record->num_defs = rh.num_defs;
+    record->num_uses = rh.num_uses;
+    record->names_len = rh.names_len;
+    record->reserved = 0;
+    lay_out_record(record, data + pos);
+    pos += body;
+    if (!record_is_valid(record)) {
+      return -1;
+    }
+    cache->len++;
+  }
+  return pos == len ? 0 : -1;
+}
+
+/* Builds CACHE->index. Returns -1 if memory runs out. */
+static int build_index(ChunkCache* cache) {
+  cache->index_cap = 64;
+  while (cache->index_cap < cache->len * 2) {
+    cache->index_cap *= 2;
+  }
+  cache->index = calloc(cache->index_cap, sizeof(uint32_t));
+  if (!cache->index) {
+    return -1;
+  }
+  uint32_t mask = cache->index_cap - 1;
+  for (uint32_t i = 0; i < cache->len; i++) {
+    uint32_t slot = (uint32_t)cache->records[i].hash & mask;
+    while (cache->index[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    cache->index[slot] = i + 1;
+  }
+  return 0;
+}
+
+static int write_part(FILE* file, const void* data, size_t len,
+                      size_t padded) {
+  static const char zeros[8] = {0};
+  return fwrite(data, 1, len, file) == len &&
+         fwrite(zeros, 1, padded - len, file) == padded - len;
+}
+
+/*******************************
+ * Cache Functions
+ *******************************/
+
+uint32_t split_chunks(const char* data, size_t len, SourceChunk** chunks) {
+  uint32_t count = 0;
+  uint32_t cap = 64;
+  *chunks = malloc(cap * sizeof(SourceChunk));
+  if (!*chunks) {
+    allocation_failed();
+  }
+
+  size_t pos = 0;
+  while (pos < len) {
+    SourceChunk* chunk;
+    if (count == cap) {
+      cap *= 2;
+      chunk = realloc(*chunks, cap * sizeof(SourceChunk));
+      if (!chunk) {
+        allocation_failed();
+      }
+      *chunks = chunk;
+    }
+    chunk = &(*chunks)[count++];
+    chunk->start = pos;
+    chunk->num_lines = 0;
+    chunk->hash = FNV_OFFSET;
+    for (;;) {
+      const char* newline = memchr(data + pos, '\n', len - pos);
+      size_t end = newline ? (size_t)(newline - data) + 1 : len;
+      uint64_t line_hash = FNV_OFFSET;
+      for (size_t i = pos; i < end; i++) {
+        line_hash = (line_hash ^ (unsigned char)data[i]) * FNV_PRIME;
+      }
+      chunk->hash = (chunk->hash ^ line_hash) * FNV_PRIME;
+      chunk->num_lines++;
+      pos = end;
+      /* The low bits of FNV-1a only depend on the low bits of each byte;
+         the high ones are better mixed. */
+      if (pos == len || chunk->num_lines == CHUNK_MAX_LINES ||
+          (chunk->num_lines >= CHUNK_MIN_LINES &&
+           ((line_hash >> 32) & CHUNK_BOUNDARY_MASK) == 0)) {
+        break;
+      }
+    }
+    chunk->len = pos - chunk->start;
+  }
+  return count;
+}
+
+ChunkRecord* create_chunk_record(const SourceChunk* chunk, uint32_t num_words,
+                                 uint32_t num_defs, uint32_t num_uses,
+                                 uint32_t names_len) {
+  size_t body = words_size(num_words) + defs_size(num_defs) +
+                uses_size(num_uses) + names_size(names_len);
+  ChunkRecord* record = malloc(sizeof(ChunkRecord) + body);
+  if (!record) {
+    allocation_failed();
+  }
+  /* Padding gets written to the cache file too. */
+  memset(record + 1, 0, body);
+  record->hash = chunk->hash;
+  record->len = chunk->len;
+  record->num_lines = chunk->num_lines;
+  record->num_words = num_words;
+  record->num_defs = num_defs;
+  record->num_uses = num_uses;
+  record->names_len = names_len;
+  record->reserved = 0;
+  lay_out_record(record, (char*)(record + 1));
+  return record;
+}
+
+int relocate_chunk_record(ChunkRecord* record, uint32_t base,
+                          SymbolTable* table) {
+  int error = 0;
+  for (uint32_t i = 0; i < record->num_uses; i++) {
+    ChunkUse* use = &record->uses[i];
+    uint32_t addr = base + use->index * 4;
+    int64_t label_addr = get_addr_for_symbol(table, record->names + use->name);
+    if (addr == use->addr && label_addr == use->label_addr) {
+      continue;
+    }
+    uint32_t word;
+    if (encode_inst(&use->ir, addr, label_addr, &word) != 0) {
+      error = 1;
+      continue;
+    }
+    record->words[use->index] = word;
+    use->addr = addr;
+    use->label_addr = label_addr;
+  }
+  return error ? -1 : 0;
+}
+
+void cache_load(ChunkCache* cache, const char* path) {
+  size_t len = 0;
+  cache->data = read_file(path, &len);
+  cache->records = NULL;
+  cache->len = 0;
+  cache->index = NULL;
+  cache->index_cap = 0;
+  if (cache->data &&
+      (parse_cache(cache, cache->data, len) != 0 || build_index(cache) != 0)) {
+    cache_release(cache);
+  }
+}
+
+ChunkRecord* cache_find(ChunkCache* cache, const SourceChunk* chunk) {
+  if (cache->index_cap == 0) {
+    return NULL;
+  }
+  uint32_t mask = cache->index_cap - 1;
+  for (uint32_t slot = (uint32_t)chunk->hash & mask; cache->index[slot] != 0;
+       slot = (slot + 1) & mask) {
+    ChunkRecord* record = &cache->records[cache->index[slot] - 1];
+    if (record->hash == chunk->hash && record->len == chunk->len &&
+        record->num_lines == chunk->num_lines) {
+      return record;
+    }
+  }
+  return NULL;
+}
+
+int cache_save(const char* path, ChunkRecord* const* records,
+               uint32_t count) {
+  size_t path_len = strlen(path);
+  char* tmp_path = malloc(path_len + 5);
+  if (!tmp_path) {
+    return -1;
+  }
+  memcpy(tmp_path, path, path_len);
+  memcpy(tmp_path + path_len, ".tmp", 5);
+
+  FILE* file = fopen(tmp_path, "wb");
+  int ok = file != NULL;
+  FileHeader header = {count, sizeof(ChunkUse)};
+  ok = ok && write_part(file, CACHE_MAGIC, CACHE_MAGIC_LEN, CACHE_MAGIC_LEN) &&
+       write_part(file, &header, sizeof(header), sizeof(header));
+  for (uint32_t i = 0; ok && i < count; i++) {
+    const ChunkRecord* record = records[i];
+    RecordHeader rh = {record->hash,      record->len,
+                       record->num_lines, record->num_words,
+                       record->num_defs,  record->num_uses,
+                       record->names_len, 0};
+    ok = write_part(file, &rh, sizeof(rh), sizeof(rh)) &&
+         write_part(file, record->words, (size_t)record->num_words * 4,
+                    words_size(record->num_words)) &&
+         write_part(file, record->defs, defs_size(record->num_defs),
+                    defs_size(record->num_defs)) &&
+         write_part(file, record->uses,
+                    (size_t)record->num_uses * sizeof(ChunkUse),
+                    uses_size(record->num_uses)) &&
+         write_part(file, record->names, record->names_len,
+                    names_size(record->names_len));
+  }
+  if (file && fclose(file) != 0) {
+    ok = 0;
+  }
+  if (ok && rename(tmp_path, path) != 0) {
+    ok = 0;
+  }
+  if (!ok && file) {
+    remove(tmp_path);
+  }
+  free(tmp_path);
+  return ok ? 0 : -1;
+}
+
+void cache_release(ChunkCache* cache) {
+  free(cache->data);
+  free(cache->records);
+  free(cache->index);
+  cache->data = NULL;
+  cache->records = NULL;
+  cache->index = NULL;
+  cache->len = 0;
+  cache->index_cap = 0;
+}
@@ -0,0 +1,117 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tables.h"
+#include "translate.h"
+
+/* Fewest and most lines in a chunk, and the mask that picks chunk ends (see
+   split_chunks()). A chunk averages about CHUNK_MIN_LINES + mask + 1
+   lines. */
+#define CHUNK_MIN_LINES 32
+#define CHUNK_MAX_LINES 1024
+#define CHUNK_BOUNDARY_MASK 0x3F
+
+/* A run of whole source lines. */
+typedef struct {
+  size_t start;
+  size_t len;
+  uint32_t num_lines;
+  /* Hash of the chunk's text. */
+  uint64_t hash;
+} SourceChunk;
+
+/* A label defined in a chunk: NAME is an offset into the record's names,
+   OFFSET the label's address relative to the chunk's first instruction. */
+typedef struct {
+  uint32_t name;
+  uint32_t offset;
+} ChunkDef;
+
+/* An instruction of a chunk that references a label, with what its word was
+   last encoded from. */
+typedef struct {
+  /* Index of the instruction in the chunk. */
+  uint32_t index;
+  /* Offset of the label's name in the record's names. */
+  uint32_t name;
+  /* Address of the instruction and of the label at the last encoding. */
+  uint32_t addr;
+  uint32_t reserved;
+  int64_t label_addr;
+  IrInstr ir;
+} ChunkUse;
+
+/* What pass one and pass two made of a chunk without errors: everything
+   that is needed to assemble it again without looking at its text. */
+typedef struct {
+  uint64_t hash;
+  uint64_t len;
+  uint32_t num_lines;
+  uint32_t num_words;
+  uint32_t num_defs;
+  uint32_t num_uses;
+  uint32_t names_len;
+  uint32_t reserved;
+  /* Encoded instructions; the words of the uses are valid for their
+     ADDR and LABEL_ADDR. */
+  uint32_t* words;
+  ChunkDef* defs;
+  ChunkUse* uses;
+  /* NUL-terminated label names. */
+  char* names;
+} ChunkRecord;
+
+/* The records of a cache file, looked up by chunk hash. */
+typedef struct {
+  /* The file's contents; loaded records point into it. */
+  char* data;
+  ChunkRecord* records;
+  uint32_t len;
+  /* Open-addressing index over `records`: record index plus one, 0 marks
+     an empty slot. */
+  uint32_t* index;
+  uint32_t index_cap;
+} ChunkCache;
+
+/* Splits the LEN bytes at DATA into chunks of whole lines and returns their
+   number; *CHUNKS is malloc'd. A chunk ends after a line whose hash has
+   the CHUNK_BOUNDARY_MASK bits clear, once it has CHUNK_MIN_LINES lines, so
+   chunk ends depend on nearby text only: an edit changes the chunk it is in
+   and leaves the others as they were. */
+uint32_t split_chunks(const char* data, size_t len, SourceChunk** chunks);
+
+/* Returns a record with room for the given numbers of words, defs, uses and
+   bytes of names, in one allocation that is released with free(). */
+ChunkRecord* create_chunk_record(const SourceChunk* chunk, uint32_t num_words,
+                                 uint32_t num_defs, uint32_t num_uses,
+                                 uint32_t names_len);
+
+/* Re-encodes the uses of RECORD whose own address (the chunk now starts at
+   BASE) or label address in TABLE changed. Returns -1 if one of them no
+   longer encodes; the others are updated anyway. */
+int relocate_chunk_record(ChunkRecord* record, uint32_t base,
+                          SymbolTable* table);
+
+/* Loads the cache file at PATH. A missing, unreadable or malformed file
+   gives an empty cache. */
+void cache_load(ChunkCache* cache, const char* path);
+
+/* Returns the record for a chunk with the text of CHUNK, or NULL. */
+ChunkRecord* cache_find(ChunkCache* cache, const SourceChunk* chunk);
+
+/* Writes the COUNT RECORDS to the cache file at PATH, replacing it
+   atomically. Returns -1 if the file could not be written. */
+int cache_save(const char* path, ChunkRecord* const* records, uint32_t count);
+
+void cache_release(ChunkCache* cache);
+
+#endif
@@ -0,0 +1,410 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "compress.h"
+
+#include <stdlib.h>
+
+#include "translate_utils.h"
+
+/* Quadrants (the two low bits) of compressed instructions. */
+#define C0 0x0
+#define C1 0x1
+#define C2 0x2
+
+#define REG_RA 1
+#define REG_SP 2
+
+/* A branch or jump whose target may move when the layout changes. */
+typedef struct {
+  uint32_t index;
+  /* Index of the target instruction (the program's length for a label at
+     the end). */
+  uint32_t target;
+} LayoutCandidate;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Returns 1 if REG is one of x8-x15, the registers of the 3-bit fields. */
+static int is_creg(uint32_t reg) { return reg >= 8 && reg <= 15; }
+
+/* Returns 1 if IMM fits a signed field of BITS bits. */
+static int fits_signed(int64_t imm, int bits) {
+  return imm >= -((int64_t)1 << (bits - 1)) && imm < ((int64_t)1 << (bits - 1));
+}
+
+/* Returns the bit IMM[BIT], moved to position POS. */
+static uint32_t bit(uint32_t imm, int bit, int pos) {
+  return ((imm >> bit) & 1) << pos;
+}
+
+/* CI format: funct3, imm[5], rd, imm[4:0]. */
+static uint16_t c_ci(uint32_t funct3, uint32_t imm, uint32_t rd,
+                     uint32_t op) {
+  return (uint16_t)((funct3 << 13) | bit(imm, 5, 12) | (rd << 7) |
+                    ((imm & 0x1F) << 2) | op);
+}
+
+/* CR format: funct4, rd/rs1, rs2. */
+static uint16_t c_cr(uint32_t funct4, uint32_t rd, uint32_t rs2) {
+  return (uint16_t)((funct4 << 12) | (rd << 7) | (rs2 << 2) | C2);
+}
+
+/* CA format: c.sub, c.xor, c.or and c.and. */
+static uint16_t c_ca(uint32_t funct2, uint32_t rd, uint32_t rs2) {
+  return (uint16_t)((0x23 << 10) | ((rd - 8) << 7) | (funct2 << 5) |
+                    ((rs2 - 8) << 2) | C1);
+}
+
+/* CB format with an immediate: c.srli, c.srai and c.andi. */
+static uint16_t c_cb_imm(uint32_t funct2, uint32_t rd, uint32_t imm) {
+  return (uint16_t)((0x4 << 13) | bit(imm, 5, 12) | (funct2 << 10) |
+                    ((rd - 8) << 7) | ((imm & 0x1F) << 2) | C1);
+}
+
+/* CB format for c.beqz and c.bnez: offset[8|4:3], rs1', offset[7:6|2:1|5]. */
+static uint16_t c_cb_branch(uint32_t funct3, uint32_t rs1, uint32_t off) {
+  return (uint16_t)((funct3 << 13) | bit(off, 8, 12) |
+                    (((off >> 3) & 0x3) << 10) | ((rs1 - 8) << 7) |
+                    (((off >> 6) & 0x3) << 5) | (((off >> 1) & 0x3) << 3) |
+                    bit(off, 5, 2) | C1);
+}
+
+/* CJ format for c.j and c.jal: offset[11|4|9:8|10|6|7|3:1|5]. */
+static uint16_t c_cj(uint32_t funct3, uint32_t off) {
+  return (uint16_t)((funct3 << 13) | bit(off, 11, 12) | bit(off, 4, 11) |
+                    (((off >> 8) & 0x3) << 9) | bit(off, 10, 8) |
+                    bit(off, 6, 7) | bit(off, 7, 6) |
+                    (((off >> 1) & 0x7) << 3) | bit(off, 5, 2) | C1);
+}
+
+/* CL/CS format for c.lw and c.sw: uimm[5:3], rs1', uimm[2|6], rd'/rs2'. */
+static uint16_t c_clw(uint32_t funct3, uint32_t rs1, uint32_t reg,
+                      uint32_t uimm) {
+  return (uint16_t)((funct3 << 13) | (((uimm >> 3) & 0x7) << 10) |
+                    ((rs1 - 8) << 7) | bit(uimm, 2, 6) | bit(uimm, 6, 5) |
+                    ((reg - 8) << 2) | C0);
+}
+
+static int compress_addi(const IrInstr* ir, uint16_t* half) {
+  uint32_t rd = ir->rd, rs1 = ir->rs1;
+  int32_t imm = ir->imm;
+  uint32_t u = (uint32_t)imm;
+  if (rd == 0) {
+    if (rs1 == 0 && imm == 0) {
+      *half = C1; /* c.nop */
+      return 0;
+    }
+    return -1;
+  }
+  if (rs1 == rd && imm != 0 && fits_signed(imm, 6)) {
+    *half = c_ci(0x0, u, rd, C1); /* c.addi */
+  } else if (rs1 == 0 && fits_signed(imm, 6)) {
+    *half = c_ci(0x2, u, rd, C1); /* c.li */
+  } else if (imm == 0 && rs1 != 0) {
+    *half = c_cr(0x8, rd, rs1); /* c.mv */
+  } else if (rd == REG_SP && rs1 == REG_SP && imm != 0 && imm % 16 == 0 &&
+             fits_signed(imm, 10)) {
+    /* c.addi16sp: nzimm[9], then nzimm[4|6|8:7|5]. */
+    *half = (uint16_t)((0x3 << 13) | bit(u, 9, 12) | (REG_SP << 7) |
+                       bit(u, 4, 6) | bit(u, 6, 5) | (((u >> 7) & 0x3) << 3) |
+                       bit(u, 5, 2) | C1);
+  } else if (is_creg(rd) && rs1 == REG_SP && imm > 0 && imm % 4 == 0 &&
+             imm < 1024) {
+    /* c.addi4spn: nzuimm[5:4|9:6|2|3]. */
+    *half = (uint16_t)((((u >> 4) & 0x3) << 11) | (((u >> 6) & 0xF) << 7) |
+                       bit(u, 2, 6) | bit(u, 3, 5) | ((rd - 8) << 2) | C0);
+  } else {
+    return -1;
+  }
+  return 0;
+}
+
+/* add, and the commutative CA-format instructions, whose operands may be
+   given in either order. */
+static int compress_rtype(const IrInstr* ir, uint16_t* half) {
+  uint32_t rd = ir->rd, rs1 = ir->rs1, rs2 = ir->rs2;
+  uint32_t funct2;
+  switch (ir->op) {
+    case INSTR_ADD:
+      if (rd == 0) {
+        return -1;
+      }
+      if (rs1 == 0 && rs2 != 0) {
+        *half = c_cr(0x8, rd, rs2); /* c.mv */
+      } else if (rs2 == 0 && rs1 != 0) {
+        *half = c_cr(0x8, rd, rs1);
+      } else if (rs1 == rd && rs2 != 0) {
+        *half = c_cr(0x9, rd, rs2); /* c.add */
+      } else if (rs2 == rd && rs1 != 0) {
+        *half = c_cr(0x9, rd, rs1);
+      } else {
+        return -1;
+      }
+      return 0;
+    case INSTR_SUB:
+      if (!is_creg(rd) || rs1 != rd || !is_creg(rs2)) {
+        return -1;
+      }
+      *half = c_ca(0x0, rd, rs2);
+      return 0;
+    case INSTR_XOR:
+      funct2 = 0x1;
+      break;
+    case INSTR_OR:
+      funct2 = 0x2;
+      break;
+    case INSTR_AND:
+      funct2 = 0x3;
+      break;
+    default:
+      return -1;
+  }
+  if (rs2 == rd) {
+    rs2 = rs1;
+  } else if (rs1 != rd) {
+    return -1;
+  }
+  if (!is_creg(rd) || !is_creg(rs2)) {
+    return -1;
+  }
+  *half = c_ca(funct2, rd, rs2);
+  return 0;
+}
+
+/* Returns the branches and jumps of PROG that refer to another instruction,
+   by label or by a numeric offset that lands on one, and their number in
+   *COUNT. */
+static LayoutCandidate* find_candidates(const IrProgram* prog,
+                                        SymbolTable* table, uint32_t* count) {
+  LayoutCandidate* candidates = NULL;
+  uint32_t len = 0;
+  uint32_t cap = 0;
+  for (uint32_t i = 0; i < prog->len; i++) {
+    const IrInstr* ir = &prog->code[i];
+    if (ir->op != INSTR_JAL && (ir->op < INSTR_BEQ || ir->op > INSTR_BGEU)) {
+      continue;
+    }
+    int64_t addr;
+    if (ir->sym != IR_NO_SYMBOL) {
+      addr = get_addr_for_symbol(table, prog->refs[ir->sym]);
+    } else {
+      addr = (int64_t)i * 4 + ir->imm;
+    }
+    if (addr < 0 || addr % 4 != 0 || addr / 4 > prog->len) {
+      continue;
+    }
+    if (len == cap) {
+      cap = cap ? cap * 2 : INCREMENT_OF_CAP;
+      LayoutCandidate* grown = realloc(candidates, cap * sizeof(*candidates));
+      if (!grown) {
+        free(candidates);
+        allocation_failed();
+      }
+      candidates = grown;
+    }
+    candidates[len].index = i;
+    candidates[len].target = (uint32_t)(addr / 4);
+    len++;
+  }
+  *count = len;
+  return candidates;
+}
+
+/* Returns 1 if the candidate C compresses at the layout ADDRS. */
+static int candidate_compresses(const IrProgram* prog,
+                                const LayoutCandidate* c,
+                                const uint32_t* addrs) {
+  IrInstr ir = prog->code[c->index];
+  uint16_t half;
+  if (ir.sym == IR_NO_SYMBOL) {
+    ir.imm = (int32_t)(addrs[c->target] - addrs[c->index]);
+  }
+  return compress_inst(&ir, addrs[c->index], addrs[c->target], &half) == 0;
+}
+
+/*******************************
+ * Compression
+ *******************************/
+
+int compress_inst(const IrInstr* ir, uint32_t addr, int64_t label_addr,
+                  uint16_t* half) {
+  uint32_t rd = ir->rd, rs1 = ir->rs1, rs2 = ir->rs2;
+  int32_t imm = ir->imm;
+  uint32_t u = (uint32_t)imm;
+  int has_label = ir->sym != IR_NO_SYMBOL;
+  if (ir->op == IR_INVALID || (has_label && label_addr == -1)) {
+    return -1;
+  }
+  /* Only branches and jal can use a label in a compressed form; the
+     auipc pairs keep their four-byte halves. */
+  if (has_label) {
+    if (ir->op != INSTR_JAL && (ir->op < INSTR_BEQ || ir->op > INSTR_BGEU)) {
+      return -1;
+    }
+    imm = (int32_t)(label_addr - (int64_t)addr);
+    u = (uint32_t)imm;
+  }
+
+  switch (ir->op) {
+    case INSTR_ADD:
+    case INSTR_SUB:
+    case INSTR_XOR:
+    case INSTR_OR:
+    case INSTR_AND:
+      return compress_rtype(ir, half);
+    case INSTR_ADDI:
+      return compress_addi(ir, half);
+    case INSTR_ANDI:
+      if (!is_creg(rd) || rs1 != rd || !fits_signed(imm, 6)) {
+        return -1;
+      }
+      *half = c_cb_imm(0x2, rd, u);
+      return 0;
+    case INSTR_SLLI:
+      if (rd == 0 || rs1 != rd || imm == 0) {
+        return -1;
+      }
+      *half = c_ci(0x0, u, rd, C2);
+      return 0;
+    case INSTR_SRLI:
+    case INSTR_SRAI:
+      if (!is_creg(rd) || rs1 != rd || imm == 0) {
+        return -1;
+      }
+      *half = c_cb_imm(ir->op == INSTR_SRLI ? 0x0 : 0x1, rd, u);
+      return 0;
+    case INSTR_LUI:
+      /* c.lui takes a non-zero 6-bit signed value for bits 17:12. */
+      if (rd == 0 || rd == REG_SP || u == 0 || (u > 0x1F && u < 0xFFFE0)) {
+        return -1;
+      }
+      *half = c_ci(0x3, u & 0x3F, rd, C1);
+      return 0;
+    case INSTR_LW:
+      if (imm < 0 || imm % 4 != 0) {
+        return -1;
+      }
+      if (rs1 == REG_SP && rd != 0 && imm < 256) {
+        /* c.lwsp: uimm[5], then uimm[4:2|7:6]. */
+        *half = (uint16_t)((0x2 << 13) | bit(u, 5, 12) | (rd << 7) |
+                           (((u >> 2) & 0x7) << 4) | (((u >> 6) & 0x3) << 2) |
+                           C2);
+        return 0;
+      }
+      if (!is_creg(rd) || !is_creg(rs1) || imm >= 128) {
+        return -1;
+      }
+      *half = c_clw(0x2, rs1, rd, u);
+      return 0;
+    case INSTR_SW:
+      if (imm < 0 || imm % 4 != 0) {
+        return -1;
+      }
+      if (rs1 == REG_SP && imm < 256) {
+        /* c.swsp: uimm[5:2|7:6]. */
+        *half = (uint16_t)((0x6 << 13) | (((u >> 2) & 0xF) << 9) |
+                           (((u >> 6) & 0x3) << 7) | (rs2 << 2) | C2);
+        return 0;
+      }
+      if (!is_creg(rs1) || !is_creg(rs2) || imm >= 128) {
+        return -1;
+      }
+      *half = c_clw(0x6, rs1, rs2, u);
+      return 0;
+    case INSTR_JALR:
+      if (rs1 == 0 || imm != 0 || (rd != 0 && rd != REG_RA)) {
+        return -1;
+      }
+      *half = c_cr(rd == 0 ? 0x8 : 0x9, rs1, 0); /* c.jr, c.jalr */
+      return 0;
+    case INSTR_JAL:
+      if ((rd != 0 && rd != REG_RA) || !fits_signed(imm, 12)) {
+        return -1;
+      }
+      *half = c_cj(rd == 0 ? 0x5 : 0x1, u); /* c.j, c.jal */
+      return 0;
+    case INSTR_BEQ:
+    case INSTR_BNE:
+      if (!is_creg(rs1) || rs2 != 0 || !fits_signed(imm, 9)) {
+        return -1;
+      }
+      *half = c_cb_branch(ir->op == INSTR_BEQ ? 0x6 : 0x7, rs1, u);
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+uint32_t compress_program(IrProgram* prog, SymbolTable* table) {
+  uint32_t len = prog->len;
+  uint8_t* sizes = malloc((size_t)len + 1);
+  uint32_t* addrs = malloc(((size_t)len + 1) * sizeof(uint32_t));
+  if (!sizes || !addrs) {
+    free(sizes);
+    free(addrs);
+    allocation_failed();
+  }
+  uint32_t num_candidates;
+  LayoutCandidate* candidates = find_candidates(prog, table, &num_candidates);
+
+  /* Instructions without a label have one size; the candidates start out
+     compressed if their operands allow it, at any distance. */
+  for (uint32_t i = 0; i < len; i++) {
+    const IrInstr* ir = &prog->code[i];
+    uint16_t half;
+    sizes[i] = ir->sym == IR_NO_SYMBOL && compress_inst(ir, 0, 0, &half) == 0
+                   ? 2
+                   : 4;
+  }
+  for (uint32_t i = 0; i < num_candidates; i++) {
+    IrInstr ir = prog->code[candidates[i].index];
+    uint16_t half;
+    ir.imm = 0;
+    sizes[candidates[i].index] = compress_inst(&ir, 0, 0, &half) == 0 ? 2 : 4;
+  }
+
+  /* Candidates only ever widen, so this ends after at most one round per
+     candidate. */
+  int changed = 1;
+  while (changed) {
+    changed = 0;
+    uint32_t addr = 0;
+    for (uint32_t i = 0; i < len; i++) {
+      addrs[i] = addr;
+      addr += sizes[i];
+    }
+    addrs[len] = addr;
+    for (uint32_t i = 0; i < num_candidates; i++) {
+      LayoutCandidate* c = &candidates[i];
+      if (sizes[c->index] == 2 && !candidate_compresses(prog, c, addrs)) {
+        sizes[c->index] = 4;
+        changed = 1;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < num_candidates; i++) {
+    IrInstr* ir = &prog->code[candidates[i].index];
+    if (ir->sym == IR_NO_SYMBOL) {
+      ir->imm = (int32_t)(addrs[candidates[i].target] -
+                          addrs[candidates[i].index]);
+    }
+  }
+  for (uint32_t i = 0; i < table->len; i++) {
+    uint32_t index = table->entries[i].addr / 4;
+    if (index <= len) {
+      table->entries[i].addr = addrs[index];
+    }
+  }
+  free(sizes);
+  free(candidates);
+  free(prog->addrs);
+  prog->addrs = addrs;
+  return len * 4 - addrs[len];
+}
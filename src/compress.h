@@ -0,0 +1,38 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stdint.h>
+
+#include "ir.h"
+#include "tables.h"
+#include "translate.h"
+
+/* Encodes IR at address ADDR as a 16-bit RVC instruction into *HALF, if it
+   has one: c.addi, c.li, c.lui, c.mv, c.add, c.sub, c.and, ..., c.lw,
+   c.sw and their sp-relative forms, c.j, c.jal, c.jr, c.jalr, c.beqz and
+   c.bnez. LABEL_ADDR is the address of the referenced label, as for
+   encode_inst(). Returns -1 if IR has no compressed form (with these
+   operands, or this far from its label). */
+int compress_inst(const IrInstr* ir, uint32_t addr, int64_t label_addr,
+                  uint16_t* half);
+
+/* Lays PROG out with every instruction that compress_inst() accepts in
+   two bytes, before ir_resolve(). TABLE holds the addresses of pass one,
+   where each instruction takes four bytes.
+
+   A compressed branch or jump has a shorter range, and its distance to the
+   label depends on the sizes of the instructions in between, so they all
+   start out compressed and the ones out of range are widened again until
+   the layout is stable. The labels in TABLE are then moved to the new
+   addresses, PROG->addrs is set (see ir.h), and branches and jumps written
+   with a numeric offset are changed to reach the same instruction as
+   before. Returns the number of bytes saved. */
+uint32_t compress_program(IrProgram* prog, SymbolTable* table);
+
+#endif
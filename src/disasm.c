@@ -0,0 +1,439 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "disasm.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+/* Column of the address comment. */
+#define COMMENT_COLUMN 32
+
+static const char* const reg_names[32] = {
+    "zero", "ra", "sp", "gp", "tp",  "t0",  "t1", "t2", "s0", "s1", "a0",
+    "a1",   "a2", "a3", "a4", "a5",  "a6",  "a7", "s2", "s3", "s4", "s5",
+    "s6",   "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+
+/* One line of the listing. */
+typedef struct {
+  char buf[128];
+  size_t len;
+} Line;
+
+/* The labels of the symbol table in address order. */
+typedef struct {
+  const Symbol** sorted;
+  uint32_t len;
+  /* First label not written yet. */
+  uint32_t next;
+} Labels;
+
+/*******************************
+ * Decoding
+ *******************************/
+
+static int funct7_slot(uint32_t funct7) {
+  switch (funct7) {
+    case 0x00:
+      return 0;
+    case 0x20:
+      return 1;
+    case 0x01:
+      return 2;
+    default:
+      return 3;
+  }
+}
+
+void build_decode_table(DecodeTable* table) {
+  memset(table->ops, IR_INVALID, sizeof(table->ops));
+  for (int id = 0; id < NUM_INSTRS; id++) {
+    const InstrInfo* info = instr_info((InstrId)id);
+    /* U and UJ instructions have no funct3. */
+    int any_funct3 = info->instr_type == U_TYPE || info->instr_type == UJ_TYPE;
+    /* funct7 tells R-type instructions and srli/srai apart; elsewhere
+       those bits belong to the immediate. */
+    int by_funct7 =
+        info->instr_type == R_TYPE || info->imm_type == IMM_5_UNSIGNED;
+    for (uint32_t f3 = 0; f3 < 8; f3++) {
+      if (!any_funct3 && f3 != info->funct3) {
+        continue;
+      }
+      for (int slot = 0; slot < 4; slot++) {
+        if (!by_funct7 || slot == funct7_slot(info->funct7)) {
+          table->ops[info->opcode >> 2][f3][slot] = (uint8_t)id;
+        }
+      }
+    }
+  }
+}
+
+int decode_word(const DecodeTable* table, uint32_t word, IrInstr* ir) {
+  if ((word & 0x3) != 0x3) {
+    return -1;
+  }
+  uint8_t op = table->ops[(word >> 2) & 0x1F][(word >> 12) & 0x7]
+                         [funct7_slot(word >> 25)];
+  if (op == IR_INVALID) {
+    return -1;
+  }
+  const InstrInfo* info = instr_info((InstrId)op);
+  ir->op = op;
+  ir->rd = (word >> 7) & 0x1F;
+  ir->rs1 = (word >> 15) & 0x1F;
+  ir->rs2 = (word >> 20) & 0x1F;
+  ir->imm = 0;
+  ir->sym = IR_NO_SYMBOL;
+
+  switch (info->instr_type) {
+    case R_TYPE:
+      return 0;
+    case I_TYPE:
+      ir->rs2 = 0;
+      if (info->imm_type == IMM_NONE) {
+        return word == info->opcode ? 0 : -1;
+      }
+      if (info->imm_type == IMM_5_UNSIGNED) {
+        ir->imm = (word >> 20) & 0x1F;
+      } else {
+        ir->imm = (int32_t)word >> 20;
+      }
+      return 0;
+    case S_TYPE:
+      ir->rd = 0;
+      ir->imm = ((int32_t)(word & 0xFE000000) >> 20) | ((word >> 7) & 0x1F);
+      return 0;
+    case SB_TYPE:
+      ir->rd = 0;
+      ir->imm = ((int32_t)(word & 0x80000000) >> 19) | ((word & 0x80) << 4) |
+                ((word >> 20) & 0x7E0) | ((word >> 7) & 0x1E);
+      return 0;
+    case U_TYPE:
+      ir->rs1 = 0;
+      ir->rs2 = 0;
+      ir->imm = (int32_t)(word >> 12);
+      return 0;
+    case UJ_TYPE:
+      ir->rs1 = 0;
+      ir->rs2 = 0;
+      ir->imm = ((int32_t)(word & 0x80000000) >> 11) | (word & 0xFF000) |
+                ((word >> 9) & 0x800) | ((word >> 20) & 0x7FE);
+      return 0;
+  }
+  return -1;
+}
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+static void put_str(Line* line, const char* str) {
+  size_t len = strlen(str);
+  if (line->len + len < sizeof(line->buf)) {
+    memcpy(line->buf + line->len, str, len);
+    line->len += len;
+  }
+}
+
+static void put_char(Line* line, char c) {
+  if (line->len + 1 < sizeof(line->buf)) {
+    line->buf[line->len++] = c;
+  }
+}
+
+static void put_reg(Line* line, uint8_t reg) {
+  put_char(line, ' ');
+  put_str(line, reg_names[reg]);
+}
+
+static void put_int(Line* line, int64_t value) {
+  char digits[24];
+  int n = 0;
+  uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+  do {
+    digits[n++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  if (value < 0) {
+    put_char(line, '-');
+  }
+  while (n > 0) {
+    put_char(line, digits[--n]);
+  }
+}
+
+/* Appends VALUE as DIGITS upper-case hex digits. */
+static void put_hex(Line* line, uint32_t value, int digits) {
+  static const char hex[] = "0123456789ABCDEF";
+  if (line->len + (size_t)digits >= sizeof(line->buf)) {
+    return;
+  }
+  for (int i = digits; i-- > 0;) {
+    line->buf[line->len + (size_t)i] = hex[value & 0xF];
+    value >>= 4;
+  }
+  line->len += (size_t)digits;
+}
+
+static int compare_symbols(const void* a, const void* b) {
+  const Symbol* x = *(const Symbol* const*)a;
+  const Symbol* y = *(const Symbol* const*)b;
+  if (x->addr != y->addr) {
+    return x->addr < y->addr ? -1 : 1;
+  }
+  /* Keep the table's order among labels at the same address. */
+  return x < y ? -1 : x > y;
+}
+
+/* Name of the first label at ADDR, or NULL. */
+static const char* label_at(const Labels* labels, int64_t addr) {
+  uint32_t lo = 0;
+  uint32_t hi = labels->len;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if ((int64_t)labels->sorted[mid]->addr < addr) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < labels->len && labels->sorted[lo]->addr == addr) {
+    return labels->sorted[lo]->name;
+  }
+  return NULL;
+}
+
+/* Writes the labels before address ADDR that have not been written. */
+static void write_labels(Labels* labels, uint64_t addr, OutputWriter* output) {
+  while (labels->next < labels->len &&
+         labels->sorted[labels->next]->addr < addr) {
+    const char* name = labels->sorted[labels->next++]->name;
+    writer_write(output, name, strlen(name));
+    writer_write(output, ":\n", 2);
+  }
+}
+
+/* Appends a branch or jump target: the label at ADDR + OFFSET, or OFFSET. */
+static void put_target(Line* line, const Labels* labels, uint32_t addr,
+                       int32_t offset) {
+  const char* name = label_at(labels, (int64_t)addr + offset);
+  put_char(line, ' ');
+  if (name) {
+    put_str(line, name);
+  } else {
+    put_int(line, offset);
+  }
+}
+
+/* Appends IR, decoded at ADDR, in the syntax pass one reads. */
+static void put_inst(Line* line, const IrInstr* ir, uint32_t addr,
+                     const Labels* labels) {
+  const InstrInfo* info = instr_info((InstrId)ir->op);
+  put_str(line, "  ");
+  put_str(line, info->name);
+  switch (info->instr_type) {
+    case R_TYPE:
+      put_reg(line, ir->rd);
+      put_reg(line, ir->rs1);
+      put_reg(line, ir->rs2);
+      break;
+    case I_TYPE:
+      if (info->imm_type == IMM_NONE) {
+        break;
+      }
+      put_reg(line, ir->rd);
+      if (info->opcode == 0x03) {
+        put_char(line, ' ');
+        put_int(line, ir->imm);
+        put_char(line, '(');
+        put_str(line, reg_names[ir->rs1]);
+        put_char(line, ')');
+      } else {
+        put_reg(line, ir->rs1);
+        put_char(line, ' ');
+        put_int(line, ir->imm);
+      }
+      break;
+    case S_TYPE:
+      put_reg(line, ir->rs2);
+      put_char(line, ' ');
+      put_int(line, ir->imm);
+      put_char(line, '(');
+      put_str(line, reg_names[ir->rs1]);
+      put_char(line, ')');
+      break;
+    case SB_TYPE:
+      put_reg(line, ir->rs1);
+      put_reg(line, ir->rs2);
+      put_target(line, labels, addr, ir->imm);
+      break;
+    case U_TYPE:
+      put_reg(line, ir->rd);
+      put_char(line, ' ');
+      put_int(line, ir->imm);
+      break;
+    case UJ_TYPE:
+      put_reg(line, ir->rd);
+      put_target(line, labels, addr, ir->imm);
+      break;
+  }
+}
+
+/* Writes the instruction of SIZE bytes (2 or 4) at ADDR. */
+static void write_parcel(const DecodeTable* table, Labels* labels,
+                         uint32_t addr, uint32_t value, int size,
+                         OutputWriter* output) {
+  Line line;
+  IrInstr ir;
+  line.len = 0;
+  write_labels(labels, (uint64_t)addr + 1, output);
+  if (size == 2) {
+    put_str(&line, "  .half 0x");
+    put_hex(&line, value, 4);
+  } else if (decode_word(table, value, &ir) == 0) {
+    put_inst(&line, &ir, addr, labels);
+  } else {
+    put_str(&line, "  .word 0x");
+    put_hex(&line, value, 8);
+  }
+  if (line.len < COMMENT_COLUMN) {
+    memset(line.buf + line.len, ' ', COMMENT_COLUMN - line.len);
+    line.len = COMMENT_COLUMN;
+  } else {
+    put_char(&line, ' ');
+  }
+  put_str(&line, "# ");
+  put_hex(&line, addr, 8);
+  put_str(&line, ": ");
+  put_hex(&line, value, size * 2);
+  put_char(&line, '\n');
+  writer_write(output, line.buf, line.len);
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+/*******************************
+ * Disassembly
+ *******************************/
+
+/* Lines of "0x" and 1-8 hex digits; 4 digits or fewer are a compressed
+   instruction, as writer_put_half() writes them. */
+static int disassemble_hex(const DecodeTable* table, Labels* labels,
+                           const char* data, size_t len, uint32_t* end,
+                           OutputWriter* output) {
+  uint32_t addr = 0;
+  uint32_t line_number = 1;
+  size_t i = 0;
+  while (i < len) {
+    size_t start = i;
+    while (i < len && (data[i] == ' ' || data[i] == '\t' || data[i] == '\r')) {
+      i++;
+    }
+    if (i < len && data[i] == '\n') {
+      i++;
+      line_number++;
+      continue;
+    }
+    if (i == len) {
+      break;
+    }
+    uint32_t value = 0;
+    int digits = 0;
+    int ok = i + 1 < len && data[i] == '0' &&
+             (data[i + 1] == 'x' || data[i + 1] == 'X');
+    if (ok) {
+      for (i += 2; i < len && hex_digit(data[i]) >= 0 && digits < 9; i++) {
+        value = value << 4 | (uint32_t)hex_digit(data[i]);
+        digits++;
+      }
+      while (i < len &&
+             (data[i] == ' ' || data[i] == '\t' || data[i] == '\r')) {
+        i++;
+      }
+      ok = digits > 0 && digits <= 8 && (i == len || data[i] == '\n');
+    }
+    if (!ok) {
+      size_t stop = start;
+      while (stop < len && data[stop] != '\n') {
+        stop++;
+      }
+      write_to_log("Error - invalid word at line %u: %.*s\n", line_number,
+                   (int)(stop - start), data + start);
+      return -1;
+    }
+    int size = digits <= 4 ? 2 : 4;
+    write_parcel(table, labels, addr, value, size, output);
+    addr += (uint32_t)size;
+  }
+  *end = addr;
+  return 0;
+}
+
+/* Little-endian parcels; one whose low two bits are not 11 is compressed. */
+static int disassemble_bin(const DecodeTable* table, Labels* labels,
+                           const unsigned char* data, size_t len,
+                           uint32_t* end, OutputWriter* output) {
+  size_t i = 0;
+  while (i < len) {
+    uint32_t value = i + 1 < len ? (uint32_t)(data[i] | data[i + 1] << 8) : 0;
+    int size = (value & 0x3) == 0x3 ? 4 : 2;
+    if (i + (size_t)size > len) {
+      write_to_log("Error - partial instruction at byte %lu\n",
+                   (unsigned long)i);
+      return -1;
+    }
+    if (size == 4) {
+      value |= (uint32_t)(data[i + 2] | data[i + 3] << 8) << 16;
+    }
+    write_parcel(table, labels, (uint32_t)i, value, size, output);
+    i += (size_t)size;
+  }
+  *end = (uint32_t)len;
+  return 0;
+}
+
+int disassemble(const char* data, size_t len, int binary,
+                const SymbolTable* symbols, OutputWriter* output) {
+  DecodeTable table;
+  build_decode_table(&table);
+
+  Labels labels;
+  labels.len = symbols ? symbols->len : 0;
+  labels.next = 0;
+  labels.sorted = malloc(((size_t)labels.len + 1) * sizeof(Symbol*));
+  if (!labels.sorted) {
+    allocation_failed();
+  }
+  for (uint32_t i = 0; i < labels.len; i++) {
+    labels.sorted[i] = &symbols->entries[i];
+  }
+  qsort(labels.sorted, labels.len, sizeof(Symbol*), compare_symbols);
+
+  uint32_t end = 0;
+  int err = binary ? disassemble_bin(&table, &labels,
+                                     (const unsigned char*)data, len, &end,
+                                     output)
+                   : disassemble_hex(&table, &labels, data, len, &end, output);
+  if (err == 0) {
+    /* Labels at the end of the code, or past it. */
+    write_labels(&labels, UINT64_MAX, output);
+  }
+  free(labels.sorted);
+  return err;
+}
@@ -0,0 +1,51 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef DISASM_H
+#define DISASM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tables.h"
+#include "translate.h"
+#include "writer.h"
+
+/* Maps the major opcode (bits 6:2), funct3 and funct7 of a word to its
+   InstrId, or IR_INVALID. The last index is 0, 1 or 2 for a funct7 of
+   0x00, 0x20 or 0x01, and 3 for anything else; instructions whose funct7
+   bits are part of the immediate are entered under all four. */
+typedef struct {
+  uint8_t ops[32][8][4];
+} DecodeTable;
+
+/* Fills TABLE from `instr_table`. */
+void build_decode_table(DecodeTable* table);
+
+/* Decodes the 32-bit instruction WORD into IR, the inverse of
+   encode_inst(): branch and jump immediates are the offset to the target,
+   and IR->sym is IR_NO_SYMBOL. Returns -1 if WORD is not one of the
+   instructions of `instr_table`. */
+int decode_word(const DecodeTable* table, uint32_t word, IrInstr* ir);
+
+/* Writes the LEN bytes of the image at DATA to OUTPUT as assembly, one
+   instruction per line, followed by a comment with its address and
+   encoding. The image is either the text of a hex .out file or, if BINARY
+   is set, raw little-endian instructions.
+
+   Registers are written with their ABI names. If SYMBOLS is not NULL, its
+   labels are written before the instructions at their addresses, and
+   branches and jumps to a label name it, so that assembling the output
+   gives back the same image and symbol table. Compressed instructions and
+   words that do not decode are written as `.half` and `.word` lines.
+
+   Returns 0 on success and -1 if the image is malformed (a line that is
+   not a hex word, or a partial instruction at the end), after logging the
+   error. */
+int disassemble(const char* data, size_t len, int binary,
+                const SymbolTable* symbols, OutputWriter* output);
+
+#endif
@@ -0,0 +1,279 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "ir.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compress.h"
+#include "translate_utils.h"
+#include "utils.h"
+
+/* Initial number of slots in the reference index. Must be a power of two. */
+#define INITIAL_REF_INDEX_CAP 64
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Returns the ref_index slot holding LABEL, or the empty slot where LABEL
+   would be inserted. The index is never full, so the probe always ends. */
+static uint32_t* find_ref(IrProgram* prog, const char* label) {
+  uint32_t mask = prog->ref_index_cap - 1;
+  uint32_t pos = hash_string(label) & mask;
+  while (prog->ref_index[pos] != 0 &&
+         strcmp(prog->refs[prog->ref_index[pos] - 1], label) != 0) {
+    pos = (pos + 1) & mask;
+  }
+  return &prog->ref_index[pos];
+}
+
+/* Doubles the reference index (or creates it) and reinserts every
+   reference. */
+static void grow_ref_index(IrProgram* prog) {
+  uint32_t new_cap =
+      prog->ref_index_cap ? prog->ref_index_cap * 2 : INITIAL_REF_INDEX_CAP;
+  uint32_t* index = calloc(new_cap, sizeof(uint32_t));
+  if (!index) {
+    allocation_failed();
+  }
+  free(prog->ref_index);
+  prog->ref_index = index;
+  prog->ref_index_cap = new_cap;
+  for (uint32_t i = 0; i < prog->num_refs; i++) {
+    *find_ref(prog, prog->refs[i]) = i + 1;
+  }
+}
+
+/* Returns the reference id of LABEL, which is added on first use. */
+static uint32_t add_ref(IrProgram* prog, const char* label) {
+  /* Keep the index at most half full so probe sequences stay short. */
+  if ((prog->num_refs + 1) * 2 > prog->ref_index_cap) {
+    grow_ref_index(prog);
+  }
+  uint32_t* slot = find_ref(prog, label);
+  if (*slot != 0) {
+    return *slot - 1;
+  }
+  if (prog->num_refs == prog->refs_cap) {
+    uint32_t new_cap = prog->refs_cap ? prog->refs_cap * 2 : INCREMENT_OF_CAP;
+    const char** refs = realloc(prog->refs, new_cap * sizeof(*refs));
+    if (!refs) {
+      allocation_failed();
+    }
+    prog->refs = refs;
+    prog->refs_cap = new_cap;
+  }
+  char* name = arena_strdup(&prog->strings, label);
+  if (!name) {
+    allocation_failed();
+  }
+  prog->refs[prog->num_refs] = name;
+  *slot = ++prog->num_refs;
+  return prog->num_refs - 1;
+}
+
+/* Returns a copy of the text of instruction NAME ARGS in PROG's strings,
+   as log_inst() would print it. */
+static const char* keep_text(IrProgram* prog, const char* name,
+                             char* const* args, uint32_t num_args) {
+  size_t len = strlen(name);
+  for (uint32_t i = 0; i < num_args; i++) {
+    len += 1 + strlen(args[i]);
+  }
+  char* text = arena_alloc(&prog->strings, len + 1);
+  if (!text) {
+    allocation_failed();
+  }
+  size_t pos = strlen(name);
+  memcpy(text, name, pos);
+  for (uint32_t i = 0; i < num_args; i++) {
+    size_t arg_len = strlen(args[i]);
+    text[pos++] = ' ';
+    memcpy(text + pos, args[i], arg_len);
+    pos += arg_len;
+  }
+  text[pos] = '\0';
+  return text;
+}
+
+/*******************************
+ * IR Functions
+ *******************************/
+
+void ir_init(IrProgram* prog, uint32_t cap) {
+  prog->cap = cap > INCREMENT_OF_CAP ? cap : INCREMENT_OF_CAP;
+  prog->len = 0;
+  prog->refs = NULL;
+  prog->ref_addrs = NULL;
+  prog->num_refs = 0;
+  prog->refs_cap = 0;
+  prog->ref_index = NULL;
+  prog->ref_index_cap = 0;
+  prog->addrs = NULL;
+  arena_init(&prog->strings);
+  prog->code = malloc(prog->cap * sizeof(IrInstr));
+  prog->sources = malloc(prog->cap * sizeof(IrSource));
+  if (!prog->code || !prog->sources) {
+    free(prog->code);
+    free(prog->sources);
+    prog->code = NULL;
+    prog->sources = NULL;
+    prog->cap = 0;
+    allocation_failed();
+  }
+}
+
+void ir_release(IrProgram* prog) {
+  free(prog->code);
+  free(prog->sources);
+  free(prog->refs);
+  free(prog->ref_addrs);
+  free(prog->ref_index);
+  free(prog->addrs);
+  arena_release(&prog->strings);
+  prog->code = NULL;
+  prog->sources = NULL;
+  prog->refs = NULL;
+  prog->ref_addrs = NULL;
+  prog->ref_index = NULL;
+  prog->addrs = NULL;
+  prog->len = prog->cap = 0;
+  prog->num_refs = prog->refs_cap = 0;
+  prog->ref_index_cap = 0;
+}
+
+void ir_clear(IrProgram* prog) {
+  prog->len = 0;
+  prog->num_refs = 0;
+  if (prog->ref_index) {
+    memset(prog->ref_index, 0, prog->ref_index_cap * sizeof(uint32_t));
+  }
+  arena_reset(&prog->strings);
+  free(prog->addrs);
+  prog->addrs = NULL;
+}
+
+void ir_reserve(IrProgram* prog, uint32_t len) {
+  if (len <= prog->cap) {
+    return;
+  }
+  /* Grow geometrically, as the program is built a line at a time. */
+  uint32_t new_cap = prog->cap * 2;
+  if (new_cap < len) {
+    new_cap = len;
+  }
+  IrInstr* code = realloc(prog->code, new_cap * sizeof(IrInstr));
+  if (!code) {
+    allocation_failed();
+  }
+  prog->code = code;
+  IrSource* sources = realloc(prog->sources, new_cap * sizeof(IrSource));
+  if (!sources) {
+    allocation_failed();
+  }
+  prog->sources = sources;
+  prog->cap = new_cap;
+}
+
+void ir_append(IrProgram* prog, uint32_t line, const char* name, char** args,
+               uint32_t num_args) {
+  if (prog->len == prog->cap) {
+    ir_reserve(prog, prog->len + 1);
+  }
+  IrInstr* ir = &prog->code[prog->len];
+  IrSource* source = &prog->sources[prog->len];
+  const char* label;
+  source->line = line;
+  prog->len++;
+  source->text = keep_text(prog, name, args, num_args);
+  if (decode_inst(ir, &label, name, args, num_args) != 0) {
+    ir->op = IR_INVALID;
+  } else if (label) {
+    ir->sym = add_ref(prog, label);
+  }
+}
+
+void ir_build(IrProgram* prog, Block* blk) {
+  ir_reserve(prog, prog->len + blk->len);
+  for (uint32_t i = 0; i < blk->len; i++) {
+    Instr* inst = &blk->entries[i];
+    ir_append(prog, inst->line_number, inst->name, inst->args,
+              inst->arg_num);
+  }
+}
+
+void ir_resolve(IrProgram* prog, SymbolTable* table) {
+  free(prog->ref_addrs);
+  prog->ref_addrs = malloc((prog->num_refs + 1) * sizeof(int64_t));
+  if (!prog->ref_addrs) {
+    allocation_failed();
+  }
+  for (uint32_t i = 0; i < prog->num_refs; i++) {
+    prog->ref_addrs[i] = get_addr_for_symbol(table, prog->refs[i]);
+  }
+}
+
+int ir_emit(const IrProgram* prog, uint32_t index, OutputWriter* output) {
+  const IrInstr* ir = &prog->code[index];
+  if (ir->op == IR_INVALID) {
+    return -1;
+  }
+  int64_t label_addr = ir->sym == IR_NO_SYMBOL ? 0 : prog->ref_addrs[ir->sym];
+  uint32_t addr = prog->addrs ? prog->addrs[index] : index * 4;
+  if (prog->addrs && prog->addrs[index + 1] - addr == 2) {
+    uint16_t half;
+    if (compress_inst(ir, addr, label_addr, &half) != 0) {
+      return -1;
+    }
+    writer_put_half(output, half);
+    return 0;
+  }
+  uint32_t word;
+  if (encode_inst(ir, addr, label_addr, &word) != 0) {
+    return -1;
+  }
+  write_inst(output, word);
+  return 0;
+}
+
+void ir_get_text(IrProgram* prog, uint32_t index, IrText* text) {
+  char* copy = arena_strdup(&prog->strings, prog->sources[index].text);
+  if (!copy) {
+    allocation_failed();
+  }
+  /* Tokens never contain a space, so the text splits back into them. */
+  text->name = copy;
+  text->num_args = 0;
+  for (char* pos = strchr(copy, ' '); pos && text->num_args < MAX_ARGS;
+       pos = strchr(pos, ' ')) {
+    *pos++ = '\0';
+    text->args[text->num_args++] = pos;
+  }
+}
+
+void ir_set_text(IrProgram* prog, uint32_t index, const IrText* text) {
+  prog->sources[index].text =
+      keep_text(prog, text->name, text->args, text->num_args);
+}
+
+void ir_set_imm_text(IrProgram* prog, uint32_t index, int32_t imm) {
+  IrText text;
+  char arg[16];
+  ir_get_text(prog, index, &text);
+  snprintf(arg, sizeof(arg), "%ld", (long)imm);
+  text.args[text.num_args - 1] = arg;
+  ir_set_text(prog, index, &text);
+}
+
+void ir_write(const IrProgram* prog, FILE* output) {
+  for (uint32_t i = 0; i < prog->len; i++) {
+    fprintf(output, "%s\n", prog->sources[i].text);
+  }
+}
@@ -0,0 +1,116 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef IR_H
+#define IR_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "block.h"
+#include "tables.h"
+#include "translate.h"
+#include "writer.h"
+
+/* Where an instruction of an IrProgram came from, for its diagnostic and
+   the .inst file. */
+typedef struct {
+  /* The instruction as pass one wrote it: name and arguments, separated by
+     spaces, as log_inst() prints them. A pass that rewrites the instruction
+     rewrites its text too (see ir_set_text()). */
+  const char* text;
+  /* Source line (first line is 1). */
+  uint32_t line;
+} IrSource;
+
+/* A program in pre-decoded form. Pass one appends each instruction with
+   ir_append() as soon as its line is parsed, so the program is never held
+   as a Block; sources[i] is all that is kept of code[i]'s text.
+
+   Each label gets one reference id, however many instructions name it;
+   refs[id] is the label's name and, after ir_resolve(), ref_addrs[id] its
+   address or -1 if it is undefined.
+ */
+typedef struct {
+  IrInstr* code;
+  IrSource* sources;
+  uint32_t len;
+  uint32_t cap;
+
+  const char** refs;
+  int64_t* ref_addrs;
+  uint32_t num_refs;
+  uint32_t refs_cap;
+
+  /* Open-addressing hash index over `refs`. Each slot holds a reference id
+     plus one, 0 marks an empty slot. */
+  uint32_t* ref_index;
+  /* Number of slots in `ref_index`, 0 or a power of two. */
+  uint32_t ref_index_cap;
+
+  /* Storage for the names in `refs` and the texts in `sources`. */
+  StrArena strings;
+
+  /* NULL if every instruction takes four bytes, code[i] at address i * 4.
+     Otherwise (see compress_program()) the address of each instruction and,
+     at [len], the end; an instruction of two bytes is emitted in its
+     compressed form. */
+  uint32_t* addrs;
+} IrProgram;
+
+/* Initialize an empty program with room for CAP instructions. */
+void ir_init(IrProgram* prog, uint32_t cap);
+
+/* Free the memory held by PROG. */
+void ir_release(IrProgram* prog);
+
+/* Remove every instruction and reference, keeping the memory. */
+void ir_clear(IrProgram* prog);
+
+/* Make room for LEN instructions in PROG. */
+void ir_reserve(IrProgram* prog, uint32_t len);
+
+/* Decode the instruction NAME ARGS from source line LINE and append it to
+   PROG. An instruction that does not decode is kept as IR_INVALID, so that
+   it is reported in order in pass two. */
+void ir_append(IrProgram* prog, uint32_t line, const char* name, char** args,
+               uint32_t num_args);
+
+/* ir_append() every instruction of BLK, with the line it came from. */
+void ir_build(IrProgram* prog, Block* blk);
+
+/* Look up the address of every label reference in TABLE. */
+void ir_resolve(IrProgram* prog, SymbolTable* table);
+
+/* Encode instruction INDEX of a resolved PROG and append it to OUTPUT.
+   Returns -1, writing nothing, if the instruction is invalid. */
+int ir_emit(const IrProgram* prog, uint32_t index, OutputWriter* output);
+
+/* The text of an instruction of an IrProgram, split into its name and
+   arguments, for a pass that rewrites the instruction. */
+typedef struct {
+  const char* name;
+  char* args[MAX_ARGS];
+  uint32_t num_args;
+} IrText;
+
+/* Split the text of instruction INDEX of PROG into TEXT. The strings are
+   copies that live as long as PROG's. */
+void ir_get_text(IrProgram* prog, uint32_t index, IrText* text);
+
+/* Set the text of instruction INDEX of PROG to TEXT. */
+void ir_set_text(IrProgram* prog, uint32_t index, const IrText* text);
+
+/* Set the last argument of the text of instruction INDEX of PROG to IMM,
+   after a pass changed its offset. */
+void ir_set_imm_text(IrProgram* prog, uint32_t index, int32_t imm);
+
+/* Write PROG to OUTPUT, one instruction per line, for the .inst file of
+   --test: each instruction's text, as write_block() writes a Block. */
+void ir_write(const IrProgram* prog, FILE* output);
+
+#endif
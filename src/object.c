@@ -0,0 +1,171 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "object.h"
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Section header indices. */
+enum {
+  SEC_NULL,
+  SEC_TEXT,
+  SEC_SYMTAB,
+  SEC_STRTAB,
+  SEC_SHSTRTAB,
+  NUM_SECTIONS,
+};
+
+#define EHDR_SIZE 52
+#define SHDR_SIZE 40
+#define SYM_SIZE 16
+
+/* Section names, NUL-separated; offsets below index into this string. */
+static const char shstrtab[] = "\0.text\0.symtab\0.strtab\0.shstrtab";
+#define SHSTRTAB_LEN sizeof(shstrtab)
+#define NAME_TEXT 1
+#define NAME_SYMTAB 7
+#define NAME_STRTAB 15
+#define NAME_SHSTRTAB 23
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Little-endian stores, independent of the host byte order. */
+static void put16(unsigned char* p, uint16_t v) {
+  p[0] = (unsigned char)v;
+  p[1] = (unsigned char)(v >> 8);
+}
+
+static void put32(unsigned char* p, uint32_t v) {
+  p[0] = (unsigned char)v;
+  p[1] = (unsigned char)(v >> 8);
+  p[2] = (unsigned char)(v >> 16);
+  p[3] = (unsigned char)(v >> 24);
+}
+
+static size_t align4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+static void put_shdr(unsigned char* p, uint32_t name, uint32_t type,
+                     uint32_t flags, uint32_t offset, uint32_t size,
+                     uint32_t link, uint32_t info, uint32_t align,
+                     uint32_t entsize) {
+  put32(p, name);
+  put32(p + 4, type);
+  put32(p + 8, flags);
+  put32(p + 12, 0); /* sh_addr */
+  put32(p + 16, offset);
+  put32(p + 20, size);
+  put32(p + 24, link);
+  put32(p + 28, info);
+  put32(p + 32, align);
+  put32(p + 36, entsize);
+}
+
+static void put_sym(unsigned char* p, uint32_t name, uint32_t value,
+                    unsigned char info, uint16_t shndx) {
+  put32(p, name);
+  put32(p + 4, value);
+  put32(p + 8, 0); /* st_size */
+  p[12] = info;
+  p[13] = STV_DEFAULT;
+  put16(p + 14, shndx);
+}
+
+/*******************************
+ * ELF Output
+ *******************************/
+
+int write_elf(OutputWriter* output, const char* text, size_t text_len,
+              SymbolTable* table, int rvc) {
+  /* Symbol 0 is the null symbol, symbol 1 the .text section symbol. */
+  uint32_t num_syms = 2 + (table ? table->len : 0);
+  size_t strtab_len = 1;
+  for (uint32_t i = 0; table && i < table->len; i++) {
+    strtab_len += strlen(table->entries[i].name) + 1;
+  }
+
+  size_t symtab_len = (size_t)num_syms * SYM_SIZE;
+  unsigned char* symtab = calloc(1, symtab_len);
+  char* strtab = malloc(strtab_len);
+  if (!symtab || !strtab) {
+    free(symtab);
+    free(strtab);
+    return -1;
+  }
+  strtab[0] = '\0';
+  put_sym(symtab + SYM_SIZE, 0, 0, ELF32_ST_INFO(STB_LOCAL, STT_SECTION),
+          SEC_TEXT);
+  size_t name_off = 1;
+  for (uint32_t i = 0; table && i < table->len; i++) {
+    const Symbol* sym = &table->entries[i];
+    size_t len = strlen(sym->name) + 1;
+    memcpy(strtab + name_off, sym->name, len);
+    put_sym(symtab + (size_t)(i + 2) * SYM_SIZE, (uint32_t)name_off,
+            sym->addr, ELF32_ST_INFO(STB_LOCAL, STT_NOTYPE), SEC_TEXT);
+    name_off += len;
+  }
+
+  /* File layout: header, .text, .symtab, .strtab, .shstrtab, padding and
+     the section header table. .text and .symtab stay 4-byte aligned. */
+  size_t text_off = EHDR_SIZE;
+  size_t symtab_off = text_off + align4(text_len);
+  size_t strtab_off = symtab_off + symtab_len;
+  size_t shstrtab_off = strtab_off + strtab_len;
+  size_t shdr_off = align4(shstrtab_off + SHSTRTAB_LEN);
+
+  unsigned char ehdr[EHDR_SIZE] = {0};
+  memcpy(ehdr, ELFMAG, SELFMAG);
+  ehdr[EI_CLASS] = ELFCLASS32;
+  ehdr[EI_DATA] = ELFDATA2LSB;
+  ehdr[EI_VERSION] = EV_CURRENT;
+  ehdr[EI_OSABI] = ELFOSABI_SYSV;
+  put16(ehdr + 16, ET_REL);
+  put16(ehdr + 18, EM_RISCV);
+  put32(ehdr + 20, EV_CURRENT);
+  put32(ehdr + 24, 0); /* e_entry */
+  put32(ehdr + 28, 0); /* e_phoff */
+  put32(ehdr + 32, (uint32_t)shdr_off);
+  /* e_flags: soft-float, and EF_RISCV_RVC for compressed code. */
+  put32(ehdr + 36, rvc ? EF_RISCV_RVC : 0);
+  put16(ehdr + 40, EHDR_SIZE);
+  put16(ehdr + 42, 0); /* e_phentsize */
+  put16(ehdr + 44, 0); /* e_phnum */
+  put16(ehdr + 46, SHDR_SIZE);
+  put16(ehdr + 48, NUM_SECTIONS);
+  put16(ehdr + 50, SEC_SHSTRTAB);
+
+  unsigned char shdrs[NUM_SECTIONS * SHDR_SIZE] = {0};
+  put_shdr(shdrs + SEC_TEXT * SHDR_SIZE, NAME_TEXT, SHT_PROGBITS,
+           SHF_ALLOC | SHF_EXECINSTR, (uint32_t)text_off, (uint32_t)text_len,
+           0, 0, rvc ? 2 : 4, 0);
+  /* sh_info of .symtab is the index of the first non-local symbol. */
+  put_shdr(shdrs + SEC_SYMTAB * SHDR_SIZE, NAME_SYMTAB, SHT_SYMTAB, 0,
+           (uint32_t)symtab_off, (uint32_t)symtab_len, SEC_STRTAB, num_syms,
+           4, SYM_SIZE);
+  put_shdr(shdrs + SEC_STRTAB * SHDR_SIZE, NAME_STRTAB, SHT_STRTAB, 0,
+           (uint32_t)strtab_off, (uint32_t)strtab_len, 0, 0, 1, 0);
+  put_shdr(shdrs + SEC_SHSTRTAB * SHDR_SIZE, NAME_SHSTRTAB, SHT_STRTAB, 0,
+           (uint32_t)shstrtab_off, SHSTRTAB_LEN, 0, 0, 1, 0);
+
+  static const char padding[4] = {0};
+  writer_write(output, ehdr, EHDR_SIZE);
+  writer_write(output, text, text_len);
+  writer_write(output, padding, align4(text_len) - text_len);
+  writer_write(output, symtab, symtab_len);
+  writer_write(output, strtab, strtab_len);
+  writer_write(output, shstrtab, SHSTRTAB_LEN);
+  writer_write(output, padding,
+               shdr_off - (shstrtab_off + SHSTRTAB_LEN));
+  writer_write(output, shdrs, sizeof(shdrs));
+
+  free(symtab);
+  free(strtab);
+  return 0;
+}
@@ -0,0 +1,31 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include <stddef.h>
+
+#include "tables.h"
+#include "writer.h"
+
+/* Writes a minimal little-endian RV32 ELF relocatable object to OUTPUT.
+
+   The object has a .text section holding the TEXT_LEN bytes at TEXT (the
+   encoded instructions, little-endian) and a .symtab/.strtab pair with one
+   local symbol per entry of TABLE, defined in .text at the entry's byte
+   offset. There are no relocations: every label reference has already been
+   resolved by pass two.
+
+   If RVC is set, .text mixes 2- and 4-byte instructions and the header
+   says so (EF_RISCV_RVC).
+
+   Returns 0 on success and -1 if memory for the tables ran out.
+ */
+int write_elf(OutputWriter* output, const char* text, size_t text_len,
+              SymbolTable* table, int rvc);
+
+#endif
@@ -0,0 +1,152 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "parallel.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "translate_utils.h"
+
+/* Work and results of one pass-two shard. */
+typedef struct {
+  const IrProgram* prog;
+  /* Instructions [begin, end) of the program. */
+  uint32_t begin;
+  uint32_t end;
+
+  /* Encoded output of the shard, one element of the outputs array. */
+  OutputWriter* out;
+
+  /* Indices of instructions that failed to encode, ascending. */
+  uint32_t* failed;
+  uint32_t num_failed;
+  uint32_t failed_cap;
+
+  /* Set if the shard ran out of memory. */
+  int oom;
+} Shard;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+static void record_failure(Shard* shard, uint32_t index) {
+  if (shard->num_failed == shard->failed_cap) {
+    uint32_t new_cap = shard->failed_cap ? shard->failed_cap * 2 : 16;
+    uint32_t* failed = realloc(shard->failed, new_cap * sizeof(uint32_t));
+    if (!failed) {
+      shard->oom = 1;
+      return;
+    }
+    shard->failed = failed;
+    shard->failed_cap = new_cap;
+  }
+  shard->failed[shard->num_failed++] = index;
+}
+
+static void* encode_shard(void* arg) {
+  Shard* shard = arg;
+  for (uint32_t i = shard->begin; i < shard->end; i++) {
+    if (ir_emit(shard->prog, i, shard->out) != 0) {
+      record_failure(shard, i);
+    }
+  }
+  if (shard->out->error) {
+    shard->oom = 1;
+  }
+  return NULL;
+}
+
+static void release_shards(Shard* shards, OutputWriter* outputs, int count) {
+  for (int i = 0; i < count; i++) {
+    writer_release(&outputs[i]);
+    free(shards[i].failed);
+  }
+  free(shards);
+  free(outputs);
+}
+
+/*******************************
+ * Parallel Pass Two
+ *******************************/
+
+int encode_parallel(const IrProgram* prog, OutputWriter* output, int jobs,
+                    uint32_t** failed, uint32_t* num_failed) {
+  *failed = NULL;
+  *num_failed = 0;
+  if (jobs > MAX_JOBS) {
+    jobs = MAX_JOBS;
+  }
+  if ((uint32_t)jobs > prog->len) {
+    jobs = prog->len > 0 ? (int)prog->len : 1;
+  }
+
+  Shard* shards = calloc((size_t)jobs, sizeof(Shard));
+  OutputWriter* outputs = calloc((size_t)jobs, sizeof(OutputWriter));
+  pthread_t* threads = calloc((size_t)jobs, sizeof(pthread_t));
+  if (!shards || !outputs || !threads) {
+    free(shards);
+    free(outputs);
+    free(threads);
+    return -1;
+  }
+
+  int started = 0;
+  int error = 0;
+  for (int i = 0; i < jobs; i++) {
+    Shard* shard = &shards[i];
+    shard->prog = prog;
+    shard->begin = (uint32_t)((uint64_t)prog->len * i / jobs);
+    shard->end = (uint32_t)((uint64_t)prog->len * (i + 1) / jobs);
+    shard->out = &outputs[i];
+    writer_init_memory(shard->out);
+    shard->out->word_format = output->word_format;
+  }
+  for (; !error && started < jobs; started++) {
+    if (pthread_create(&threads[started], NULL, encode_shard,
+                       &shards[started]) != 0) {
+      error = 1;
+      break;
+    }
+  }
+  for (int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  free(threads);
+
+  uint32_t total_failed = 0;
+  for (int i = 0; i < jobs && !error; i++) {
+    error = shards[i].oom;
+    total_failed += shards[i].num_failed;
+  }
+  if (!error && total_failed > 0) {
+    *failed = malloc(total_failed * sizeof(uint32_t));
+    error = *failed == NULL;
+  }
+  if (error) {
+    release_shards(shards, outputs, jobs);
+    return -1;
+  }
+
+  /* Shards cover ascending index ranges, so concatenating them in order
+     reproduces the sequential output and failure order. */
+  writer_append(output, outputs, jobs);
+  for (int i = 0; i < jobs; i++) {
+    if (shards[i].num_failed > 0) {
+      memcpy(*failed + *num_failed, shards[i].failed,
+             shards[i].num_failed * sizeof(uint32_t));
+      *num_failed += shards[i].num_failed;
+    }
+  }
+  release_shards(shards, outputs, jobs);
+  return 0;
+}
@@ -0,0 +1,35 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdint.h>
+
+#include "ir.h"
+#include "writer.h"
+
+/* Upper limit for the number of pass-two worker threads. */
+#define MAX_JOBS 256
+
+/* Encodes every instruction of the resolved PROG on JOBS threads and writes
+   the result to OUTPUT, exactly as a sequential pass two would.
+
+   The instructions are split into JOBS contiguous shards. Each thread
+   encodes one shard into its own memory writer; the buffers are then
+   appended to OUTPUT in shard order. PROG is only read.
+
+   The indices of the instructions that failed to encode are returned in
+   ascending order through FAILED (to be released with free()) and
+   NUM_FAILED, so that the caller can report them in source order.
+
+   Returns 0 on success and -1 if a thread or a buffer could not be created;
+   nothing has been written to OUTPUT in that case.
+ */
+int encode_parallel(const IrProgram* prog, OutputWriter* output, int jobs,
+                    uint32_t** failed, uint32_t* num_failed);
+
+#endif
@@ -0,0 +1,318 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "peephole.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "translate.h"
+
+/* The program being optimized. Instructions are only marked as removed
+   until the end, so indices keep matching the addresses in the table. */
+typedef struct {
+  IrProgram* prog;
+  SymbolTable* table;
+  /* prog->code; op is IR_INVALID for an instruction that did not decode. */
+  IrInstr* code;
+  uint8_t* removed;
+  /* Set for entries a label (or a numeric branch offset) points at. */
+  uint8_t* labeled;
+} Peephole;
+
+/* A rewrite, tried at every instruction with opcode OP. APPLY returns 1 if
+   it changed the program, removing exactly one instruction, and 0
+   otherwise. */
+typedef struct {
+  uint8_t op;
+  int (*apply)(Peephole* p, uint32_t index);
+} PeepholePattern;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Instructions that have no effect besides writing rd. */
+static int is_pure(uint8_t op) {
+  return op <= INSTR_REM || (op >= INSTR_ADDI && op <= INSTR_SLTIU) ||
+         op == INSTR_LUI || op == INSTR_AUIPC;
+}
+
+/* The register IR writes, or -1. */
+static int written_reg(const IrInstr* ir) {
+  if (ir->op == IR_INVALID || ir->op == INSTR_ECALL ||
+      (ir->op >= INSTR_SB && ir->op <= INSTR_BGEU)) {
+    return -1;
+  }
+  return ir->rd;
+}
+
+/* Whether IR (possibly) reads register REG. */
+static int reads_reg(const IrInstr* ir, uint8_t reg) {
+  if (ir->op == IR_INVALID || ir->op == INSTR_ECALL) {
+    return 1;
+  }
+  if (ir->op == INSTR_LUI || ir->op == INSTR_AUIPC || ir->op == INSTR_JAL) {
+    return 0;
+  }
+  if (ir->op <= INSTR_REM || ir->op >= INSTR_SB) {
+    return ir->rs1 == reg || ir->rs2 == reg;
+  }
+  return ir->rs1 == reg;
+}
+
+/* Whether IR is a branch or jump written with a numeric offset. */
+static int has_numeric_target(const IrInstr* ir) {
+  return ((ir->op >= INSTR_BEQ && ir->op <= INSTR_BGEU) ||
+          ir->op == INSTR_JAL) &&
+         ir->sym == IR_NO_SYMBOL;
+}
+
+/* Index of the instruction a numeric branch or jump at INDEX reaches, or -1
+   if it is not one of the program's. */
+static int64_t numeric_target(const Peephole* p, uint32_t index) {
+  const IrInstr* ir = &p->code[index];
+  if (!has_numeric_target(ir) || ir->imm % 4 != 0) {
+    return -1;
+  }
+  int64_t target = (int64_t)index + ir->imm / 4;
+  return target >= 0 && target <= p->prog->len ? target : -1;
+}
+
+/* Sets *NEXT to the instruction that runs after INDEX. Returns 0 if there
+   is none, or if execution can also reach it without running INDEX. */
+static int successor(const Peephole* p, uint32_t index, uint32_t* next) {
+  for (uint32_t i = index + 1; i < p->prog->len; i++) {
+    if (p->labeled[i]) {
+      return 0;
+    }
+    if (!p->removed[i]) {
+      *next = i;
+      return p->code[i].op != IR_INVALID;
+    }
+  }
+  return 0;
+}
+
+/*******************************
+ * Patterns
+ *******************************/
+
+/* addi x x 0 (mv x x) and add x x x0. */
+static int drop_self_move(Peephole* p, uint32_t index) {
+  const IrInstr* ir = &p->code[index];
+  if (ir->rd == 0 || ir->sym != IR_NO_SYMBOL) {
+    return 0;
+  }
+  if (ir->op == INSTR_ADDI) {
+    if (ir->rs1 != ir->rd || ir->imm != 0) {
+      return 0;
+    }
+  } else if (ir->op != INSTR_ADD ||
+             !((ir->rs1 == ir->rd && ir->rs2 == 0) ||
+               (ir->rs2 == ir->rd && ir->rs1 == 0))) {
+    return 0;
+  }
+  p->removed[index] = 1;
+  return 1;
+}
+
+/* li x a (addi or lui) followed by an instruction that sets x without
+   reading it. */
+static int drop_overwritten(Peephole* p, uint32_t index) {
+  const IrInstr* ir = &p->code[index];
+  uint32_t next;
+  if (!is_pure(ir->op) || ir->rd == 0 || !successor(p, index, &next)) {
+    return 0;
+  }
+  const IrInstr* after = &p->code[next];
+  if (written_reg(after) != ir->rd || reads_reg(after, ir->rd)) {
+    return 0;
+  }
+  p->removed[index] = 1;
+  return 1;
+}
+
+/* lui x hi; addi x x lo => addi x x0 v, when v fits in 12 bits. */
+static int fold_lui_addi(Peephole* p, uint32_t index) {
+  IrInstr* ir = &p->code[index];
+  uint32_t next;
+  if (ir->op != INSTR_LUI || ir->rd == 0 || !successor(p, index, &next)) {
+    return 0;
+  }
+  const IrInstr* after = &p->code[next];
+  if (after->op != INSTR_ADDI || after->rd != ir->rd ||
+      after->rs1 != ir->rd || after->sym != IR_NO_SYMBOL) {
+    return 0;
+  }
+  int32_t value = (int32_t)(((uint32_t)ir->imm << 12) + (uint32_t)after->imm);
+  if (!is_valid_imm(value, IMM_12_SIGNED)) {
+    return 0;
+  }
+  ir->op = INSTR_ADDI;
+  ir->rs1 = 0;
+  ir->imm = value;
+  IrText text;
+  char imm[16];
+  ir_get_text(p->prog, index, &text);
+  snprintf(imm, sizeof(imm), "%d", (int)value);
+  text.name = "addi";
+  text.num_args = 3;
+  text.args[1] = "x0";
+  text.args[2] = imm;
+  ir_set_text(p->prog, index, &text);
+  p->removed[next] = 1;
+  return 1;
+}
+
+/* jal x0 to the instruction after it. */
+static int drop_jump_to_next(Peephole* p, uint32_t index) {
+  const IrInstr* ir = &p->code[index];
+  if (ir->op != INSTR_JAL || ir->rd != 0) {
+    return 0;
+  }
+  int64_t target;
+  if (ir->sym == IR_NO_SYMBOL) {
+    target = numeric_target(p, index);
+  } else {
+    int64_t addr = get_addr_for_symbol(p->table, p->prog->refs[ir->sym]);
+    target = addr < 0 ? -1 : addr / 4;
+  }
+  if (target <= (int64_t)index || target > p->prog->len) {
+    return 0;
+  }
+  for (uint32_t i = index + 1; i < target; i++) {
+    if (!p->removed[i]) {
+      return 0;
+    }
+  }
+  p->removed[index] = 1;
+  return 1;
+}
+
+static const PeepholePattern patterns[] = {
+    {INSTR_ADDI, drop_self_move},    {INSTR_ADD, drop_self_move},
+    {INSTR_LUI, fold_lui_addi},      {INSTR_ADDI, drop_overwritten},
+    {INSTR_LUI, drop_overwritten},   {INSTR_JAL, drop_jump_to_next},
+};
+
+static int apply_patterns(Peephole* p, uint32_t index) {
+  uint8_t op = p->code[index].op;
+  for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+    if (op == patterns[i].op && patterns[i].apply(p, index)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Drops the removed instructions of the program and moves the labels in
+   TABLE, and the targets of numeric branches, to the instructions that take
+   their place. */
+static void compact(Peephole* p) {
+  IrProgram* prog = p->prog;
+  uint32_t* index_map = malloc(((size_t)prog->len + 1) * sizeof(uint32_t));
+  if (!index_map) {
+    allocation_failed();
+  }
+  uint32_t live = 0;
+  for (uint32_t i = 0; i < prog->len; i++) {
+    index_map[i] = live;
+    live += !p->removed[i];
+  }
+  index_map[prog->len] = live;
+
+  for (uint32_t i = 0; i < p->table->len; i++) {
+    uint32_t index = p->table->entries[i].addr / 4;
+    if (index <= prog->len) {
+      p->table->entries[i].addr = index_map[index] * 4;
+    }
+  }
+  /* A target is computed from the old offset before it is changed, and an
+     instruction's offset only matters to itself. */
+  for (uint32_t i = 0; i < prog->len; i++) {
+    int64_t target = p->removed[i] ? -1 : numeric_target(p, i);
+    if (target < 0) {
+      continue;
+    }
+    int32_t offset =
+        (int32_t)(((int64_t)index_map[target] - index_map[i]) * 4);
+    if (offset != p->code[i].imm) {
+      p->code[i].imm = offset;
+      ir_set_imm_text(prog, i, offset);
+    }
+  }
+
+  uint32_t dst = 0;
+  for (uint32_t i = 0; i < prog->len; i++) {
+    if (!p->removed[i]) {
+      prog->code[dst] = prog->code[i];
+      prog->sources[dst] = prog->sources[i];
+      dst++;
+    }
+  }
+  prog->len = dst;
+  free(index_map);
+}
+
+/*******************************
+ * Peephole Optimization
+ *******************************/
+
+uint32_t peephole_program(IrProgram* prog, SymbolTable* table) {
+  if (prog->len == 0) {
+    return 0;
+  }
+  Peephole p;
+  p.prog = prog;
+  p.table = table;
+  p.code = prog->code;
+  p.removed = calloc(prog->len, 1);
+  p.labeled = calloc((size_t)prog->len + 1, 1);
+  if (!p.removed || !p.labeled) {
+    free(p.removed);
+    free(p.labeled);
+    allocation_failed();
+  }
+  for (uint32_t i = 0; i < table->len; i++) {
+    uint32_t index = table->entries[i].addr / 4;
+    if (index <= prog->len) {
+      p.labeled[index] = 1;
+    }
+  }
+  for (uint32_t i = 0; i < prog->len; i++) {
+    int64_t target = numeric_target(&p, i);
+    if (target >= 0) {
+      p.labeled[target] = 1;
+    }
+  }
+
+  /* After a change, the instruction before it may match with the one that
+     now follows it, so the window steps back. Every change removes an
+     instruction, so this ends. */
+  uint32_t removed = 0;
+  uint32_t i = 0;
+  while (i < prog->len) {
+    if (p.removed[i] || !apply_patterns(&p, i)) {
+      i++;
+      continue;
+    }
+    removed++;
+    for (uint32_t k = i; k-- > 0;) {
+      if (!p.removed[k]) {
+        i = k;
+        break;
+      }
+    }
+  }
+
+  if (removed) {
+    compact(&p);
+  }
+  free(p.removed);
+  free(p.labeled);
+  return removed;
+}
@@ -0,0 +1,36 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <stdint.h>
+
+#include "ir.h"
+#include "tables.h"
+
+/* Removes redundant instructions from PROG after pass one, and moves the
+   labels in TABLE to match:
+
+     addi x x 0, mv x x, add x x x0      (a move to the same register)
+     li x a; <x = ... without reading x> (a result overwritten unread)
+     lui x hi; addi x x lo               =>  addi x x0 (hi << 12) + lo
+                                             if that fits in 12 bits
+     jal x0 label                        (a jump to the next instruction)
+
+   The patterns are tried at each instruction in turn, and again at the
+   instruction before one that was changed, as removing an instruction can
+   bring two others together. A pattern of two instructions does not apply
+   if a label points at the second, and branches and jumps written with a
+   numeric offset are changed to reach the same instruction as before. The
+   canonical nop (addi x0 x0 0) is kept, as it is usually there for
+   alignment or timing.
+
+   Every instruction of PROG must be one word at TABLE's addresses, as pass
+   one leaves them. Returns the number of instructions removed. */
+uint32_t peephole_program(IrProgram* prog, SymbolTable* table);
+
+#endif
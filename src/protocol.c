@@ -0,0 +1,174 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "protocol.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* Pending connections the server lets the kernel queue. */
+#define LISTEN_BACKLOG 64
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Fill ADDR for PATH. Returns -1 if PATH does not fit. */
+static int socket_address(struct sockaddr_un* addr, const char* path) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr->sun_path)) {
+    return -1;
+  }
+  strcpy(addr->sun_path, path);
+  return 0;
+}
+
+/* Write all of IOV[0..COUNT), retrying short writes. The entries are
+   consumed as they are written. */
+static int write_iov(int fd, struct iovec* iov, int count) {
+  while (count > 0) {
+    ssize_t n = writev(fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    while (count > 0 && (size_t)n >= iov->iov_len) {
+      n -= (ssize_t)iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0) {
+      iov->iov_base = (char*)iov->iov_base + n;
+      iov->iov_len -= (size_t)n;
+    }
+  }
+  return 0;
+}
+
+/* Make *BUF hold at least NEED bytes. */
+static int reserve(char** buf, size_t* cap, size_t need) {
+  if (need <= *cap) {
+    return 0;
+  }
+  char* grown = realloc(*buf, need);
+  if (!grown) {
+    return -1;
+  }
+  *buf = grown;
+  *cap = need;
+  return 0;
+}
+
+/*******************************
+ * Protocol Functions
+ *******************************/
+
+int protocol_unlink(const char* path) {
+  struct stat st;
+  if (lstat(path, &st) != 0) {
+    return errno == ENOENT ? 0 : -1;
+  }
+  if (!S_ISSOCK(st.st_mode)) {
+    return -1;
+  }
+  return unlink(path);
+}
+
+int protocol_listen(const char* path) {
+  struct sockaddr_un addr;
+  if (socket_address(&addr, path) != 0 || protocol_unlink(path) != 0) {
+    return -1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(fd, LISTEN_BACKLOG) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int protocol_connect(const char* path) {
+  struct sockaddr_un addr;
+  if (socket_address(&addr, path) != 0) {
+    return -1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int protocol_read(int fd, void* buf, size_t len) {
+  char* p = buf;
+  while (len > 0) {
+    ssize_t n = read(fd, p, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return -1;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+int protocol_send_request(int fd, uint32_t format, const char* src,
+                          uint32_t len) {
+  RequestHeader header = {format, len};
+  struct iovec iov[2] = {{&header, sizeof(header)}, {(char*)src, len}};
+  return write_iov(fd, iov, 2);
+}
+
+int protocol_send_response(int fd, const ResponseHeader* header,
+                           const char* out, const char* log) {
+  struct iovec iov[3] = {{(ResponseHeader*)header, sizeof(*header)},
+                         {(char*)out, header->out_len},
+                         {(char*)log, header->log_len}};
+  return write_iov(fd, iov, 3);
+}
+
+int protocol_recv_response(int fd, Response* resp) {
+  ResponseHeader* header = &resp->header;
+  if (protocol_read(fd, header, sizeof(*header)) != 0 ||
+      reserve(&resp->out, &resp->out_cap, header->out_len) != 0 ||
+      reserve(&resp->log, &resp->log_cap, header->log_len) != 0 ||
+      protocol_read(fd, resp->out, header->out_len) != 0 ||
+      protocol_read(fd, resp->log, header->log_len) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+void protocol_response_release(Response* resp) {
+  free(resp->out);
+  free(resp->log);
+  resp->out = NULL;
+  resp->log = NULL;
+  resp->out_cap = 0;
+  resp->log_cap = 0;
+}
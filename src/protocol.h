@@ -0,0 +1,78 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Wire format of the --serve mode, over a Unix domain socket. Both ends are
+   on the same machine, so integers are uint32_t in host byte order.
+
+     request:  RequestHeader, then LEN bytes of source
+     response: ResponseHeader, then OUT_LEN bytes of output (in the
+               requested format) and LOG_LEN bytes of log text
+
+   A connection carries any number of requests; each is answered in order
+   before the next one is read. */
+
+/* Largest source the server accepts; a bigger request closes the
+   connection. */
+#define PROTOCOL_MAX_SOURCE (256u << 20)
+
+typedef struct {
+  /* An OutputFormat. */
+  uint32_t format;
+  uint32_t len;
+} RequestHeader;
+
+typedef struct {
+  /* An AssembleStatus. */
+  uint32_t status;
+  uint32_t out_len;
+  uint32_t log_len;
+} ResponseHeader;
+
+/* A response as received by a client. The buffers are reused (and grown) by
+   each protocol_recv_response() on the same Response. */
+typedef struct {
+  ResponseHeader header;
+  char* out;
+  size_t out_cap;
+  char* log;
+  size_t log_cap;
+} Response;
+
+/* Remove the socket file at PATH, if there is one. Returns -1, leaving PATH
+   alone, if it is anything other than a socket. */
+int protocol_unlink(const char* path);
+
+/* Bind and listen on a Unix socket at PATH, replacing any stale socket file.
+   Returns the listening descriptor, or -1 (also if PATH exists and is not a
+   socket). */
+int protocol_listen(const char* path);
+
+/* Connect to the server at PATH. Returns the descriptor, or -1. */
+int protocol_connect(const char* path);
+
+/* Read exactly LEN bytes. Returns -1 on error or end of stream. */
+int protocol_read(int fd, void* buf, size_t len);
+
+/* Send a request for SRC in FORMAT. Returns -1 on error. */
+int protocol_send_request(int fd, uint32_t format, const char* src,
+                          uint32_t len);
+
+/* Send a response made of HEADER, OUT and LOG in one write. */
+int protocol_send_response(int fd, const ResponseHeader* header,
+                           const char* out, const char* log);
+
+/* Receive the response to a request into RESP. Returns -1 on error. */
+int protocol_recv_response(int fd, Response* resp);
+
+void protocol_response_release(Response* resp);
+
+#endif
@@ -0,0 +1,234 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "relax.h"
+
+#include <stdlib.h>
+
+#include "translate.h"
+#include "translate_utils.h"
+
+/* An instruction that may have to be relaxed. */
+typedef struct {
+  uint32_t index;
+  /* Index of the instruction the label is at (the program's length for a
+     label at the end). */
+  uint32_t target;
+  /* A branch rather than a jal. */
+  int branch;
+} RelaxCandidate;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Opcode of the branch taken exactly when the branch OP is not. The
+   branches are declared in pairs, beq/bne, blt/bge and bltu/bgeu. */
+static uint8_t inverted_branch(uint8_t op) {
+  return (uint8_t)(INSTR_BEQ + ((op - INSTR_BEQ) ^ 1));
+}
+
+/* Index of the instruction a branch or jal of PROG at INDEX written with
+   a numeric offset reaches, or -1 if it is not one of the program's. */
+static int64_t numeric_target(const IrProgram* prog, uint32_t index) {
+  const IrInstr* ir = &prog->code[index];
+  int jump = (ir->op >= INSTR_BEQ && ir->op <= INSTR_BGEU) ||
+             ir->op == INSTR_JAL;
+  if (!jump || ir->sym != IR_NO_SYMBOL || ir->imm % 4 != 0) {
+    return -1;
+  }
+  int64_t target = (int64_t)index + ir->imm / 4;
+  return target >= 0 && target <= prog->len ? target : -1;
+}
+
+/* Returns the branches and the linking jals of PROG that name a defined
+   label, and their number in *COUNT. */
+static RelaxCandidate* find_candidates(const IrProgram* prog,
+                                       SymbolTable* table, uint32_t* count) {
+  RelaxCandidate* candidates = NULL;
+  uint32_t len = 0;
+  uint32_t cap = 0;
+  for (uint32_t i = 0; i < prog->len; i++) {
+    const IrInstr* ir = &prog->code[i];
+    if (ir->op == IR_INVALID || ir->sym == IR_NO_SYMBOL) {
+      continue;
+    }
+    int branch = ir->op >= INSTR_BEQ && ir->op <= INSTR_BGEU;
+    if (!branch && (ir->op != INSTR_JAL || ir->rd == 0)) {
+      continue;
+    }
+    int64_t addr = get_addr_for_symbol(table, prog->refs[ir->sym]);
+    if (addr < 0 || addr / 4 > prog->len) {
+      continue;
+    }
+    if (len == cap) {
+      cap = cap ? cap * 2 : INCREMENT_OF_CAP;
+      RelaxCandidate* grown = realloc(candidates, cap * sizeof(*candidates));
+      if (!grown) {
+        free(candidates);
+        allocation_failed();
+      }
+      candidates = grown;
+    }
+    candidates[len].index = i;
+    candidates[len].target = (uint32_t)(addr / 4);
+    candidates[len].branch = branch;
+    len++;
+  }
+  *count = len;
+  return candidates;
+}
+
+/* Sets ADDRS[i] to the address of entry I of a program of LEN entries of
+   SIZES[i] words each, and ADDRS[LEN] to the end. */
+static void layout(const uint8_t* sizes, uint32_t len, uint32_t* addrs) {
+  uint32_t addr = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    addrs[i] = addr;
+    addr += sizes[i] * 4;
+  }
+  addrs[len] = addr;
+}
+
+/* Replaces instructions of PROG with a size of two words by their long
+   form, moving the others up. GROWN is the number of such instructions.
+   Both halves of a long form keep the line of the original. */
+static void expand_program(IrProgram* prog, const uint8_t* sizes,
+                           uint32_t grown) {
+  uint32_t new_len = prog->len + grown;
+  ir_reserve(prog, new_len);
+
+  uint32_t dst = new_len;
+  for (uint32_t i = prog->len; i-- > 0;) {
+    if (sizes[i] == 1) {
+      --dst;
+      prog->code[dst] = prog->code[i];
+      prog->sources[dst] = prog->sources[i];
+      continue;
+    }
+    /* The first of the two entries may be entry I itself. */
+    IrInstr ir = prog->code[i];
+    IrSource source = prog->sources[i];
+    IrInstr* second = &prog->code[--dst];
+    prog->sources[dst] = source;
+    IrInstr* first = &prog->code[--dst];
+    prog->sources[dst] = source;
+    *first = ir;
+    *second = ir;
+    IrText text, first_text, second_text;
+    ir_get_text(prog, dst, &text);
+    first_text = text;
+    second_text = text;
+    if (ir.op != INSTR_JAL) {
+      /* bCC rs1 rs2 label => bNCC rs1 rs2 8; jal x0 label */
+      first->op = inverted_branch(ir.op);
+      first->imm = 8;
+      first->sym = IR_NO_SYMBOL;
+      second->op = INSTR_JAL;
+      second->rd = 0;
+      second->rs1 = 0;
+      second->rs2 = 0;
+      first_text.name = instr_info((InstrId)first->op)->name;
+      first_text.args[2] = "8";
+      second_text.name = "jal";
+      second_text.num_args = 2;
+      second_text.args[0] = "x0";
+      second_text.args[1] = text.args[2];
+    } else {
+      /* jal rd label => auipc rd label; jalr rd rd label */
+      first->op = INSTR_AUIPC;
+      second->op = INSTR_JALR;
+      second->rs1 = ir.rd;
+      first_text.name = "auipc";
+      second_text.name = "jalr";
+      second_text.num_args = 3;
+      second_text.args[1] = text.args[0];
+      second_text.args[2] = text.args[1];
+    }
+    ir_set_text(prog, dst, &first_text);
+    ir_set_text(prog, dst + 1, &second_text);
+  }
+  prog->len = new_len;
+}
+
+/*******************************
+ * Relaxation
+ *******************************/
+
+uint32_t relax_program(IrProgram* prog, SymbolTable* table) {
+  uint32_t num_candidates;
+  RelaxCandidate* candidates = find_candidates(prog, table, &num_candidates);
+  if (num_candidates == 0) {
+    free(candidates);
+    return 0;
+  }
+
+  uint8_t* sizes = malloc(prog->len + 1);
+  uint32_t* addrs = malloc(((size_t)prog->len + 1) * sizeof(uint32_t));
+  if (!sizes || !addrs) {
+    free(sizes);
+    free(addrs);
+    free(candidates);
+    allocation_failed();
+  }
+  for (uint32_t i = 0; i < prog->len; i++) {
+    sizes[i] = 1;
+  }
+
+  /* Instructions only ever grow, so this ends after at most one round per
+     candidate. */
+  uint32_t grown = 0;
+  int changed = 1;
+  while (changed) {
+    changed = 0;
+    layout(sizes, prog->len, addrs);
+    for (uint32_t i = 0; i < num_candidates; i++) {
+      RelaxCandidate* c = &candidates[i];
+      if (sizes[c->index] != 1) {
+        continue;
+      }
+      long offset = (long)addrs[c->target] - (long)addrs[c->index];
+      if (is_valid_imm(offset, c->branch ? IMM_13_SIGNED : IMM_21_SIGNED)) {
+        continue;
+      }
+      /* Offsets only grow, so a branch the jal after it cannot take to
+         its label now never can; pass two reports the branch. */
+      if (c->branch && !is_valid_imm(offset - 4, IMM_21_SIGNED)) {
+        continue;
+      }
+      sizes[c->index] = 2;
+      grown++;
+      changed = 1;
+    }
+  }
+
+  if (grown) {
+    for (uint32_t i = 0; i < table->len; i++) {
+      uint32_t index = table->entries[i].addr / 4;
+      if (index <= prog->len) {
+        table->entries[i].addr = addrs[index];
+      }
+    }
+    /* Numeric offsets move with their targets too. The `bNCC rs1 rs2 8`
+       of a long form is only added below, and keeps skipping its jal. */
+    for (uint32_t i = 0; i < prog->len; i++) {
+      int64_t target = numeric_target(prog, i);
+      if (target < 0) {
+        continue;
+      }
+      int32_t offset = (int32_t)((int64_t)addrs[target] - addrs[i]);
+      if (offset != prog->code[i].imm) {
+        prog->code[i].imm = offset;
+        ir_set_imm_text(prog, i, offset);
+      }
+    }
+    expand_program(prog, sizes, grown);
+  }
+  free(sizes);
+  free(addrs);
+  free(candidates);
+  return grown;
+}
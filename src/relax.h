@@ -0,0 +1,33 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef RELAX_H
+#define RELAX_H
+
+#include <stdint.h>
+
+#include "ir.h"
+#include "tables.h"
+
+/* Rewrites the instructions of PROG, after pass one, whose label is out of
+   range, and moves the labels in TABLE, and the offsets of branches and
+   jals written with a number, to match:
+
+     beq rs1 rs2 label  =>  bne rs1 rs2 8; jal x0 label
+     jal rd label       =>  auipc rd label; jalr rd rd label
+
+   (and likewise for the other branches, with the condition inverted). A
+   rewrite moves the instructions after it, which can put other labels out
+   of range, so the layout is computed again until no instruction grows.
+   Instructions in range keep their short form.
+
+   `jal x0` (`j`) has no register to spare and is left as it is, as is a
+   branch too far even for the jal; pass two reports them. Every
+   instruction of PROG must be one word at TABLE's addresses, as pass one
+   leaves them. Returns the number of instructions rewritten. */
+uint32_t relax_program(IrProgram* prog, SymbolTable* table);
+
+#endif
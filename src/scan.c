@@ -0,0 +1,225 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "scan.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_WIDTH 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCAN_WIDTH 16
+#else
+#define SCAN_WIDTH 64
+#endif
+
+/* Initial capacity of a TokenList. */
+#define INITIAL_TOKEN_CAP 1024
+
+/* Character classes for the scalar classifier. */
+#define CLASS_DELIM 1   /* ends a token */
+#define CLASS_NEWLINE 2 /* ends a line */
+#define CLASS_COMMENT 4 /* starts a comment */
+
+static const uint8_t char_class[256] = {
+    [' '] = CLASS_DELIM,
+    ['\f'] = CLASS_DELIM,
+    ['\r'] = CLASS_DELIM,
+    ['\t'] = CLASS_DELIM,
+    ['\v'] = CLASS_DELIM,
+    [','] = CLASS_DELIM,
+    ['('] = CLASS_DELIM,
+    [')'] = CLASS_DELIM,
+    ['\n'] = CLASS_DELIM | CLASS_NEWLINE,
+    ['#'] = CLASS_DELIM | CLASS_COMMENT,
+    ['\0'] = CLASS_DELIM | CLASS_COMMENT,
+};
+
+/* One bit per byte of a block, bit i for byte i. */
+typedef struct {
+  uint64_t delim;
+  uint64_t newline;
+  uint64_t comment;
+} ScanMasks;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Classify N <= 64 bytes one at a time. */
+static void classify_scalar(const char* p, size_t n, ScanMasks* m) {
+  m->delim = m->newline = m->comment = 0;
+  for (size_t i = 0; i < n; i++) {
+    uint8_t cls = char_class[(unsigned char)p[i]];
+    m->delim |= (uint64_t)(cls & CLASS_DELIM) << i;
+    m->newline |= (uint64_t)((cls & CLASS_NEWLINE) >> 1) << i;
+    m->comment |= (uint64_t)((cls & CLASS_COMMENT) >> 2) << i;
+  }
+}
+
+#if defined(__AVX2__)
+/* Classify SCAN_WIDTH bytes with AVX2. */
+static void classify_block(const char* p, ScanMasks* m) {
+  __m256i v = _mm256_loadu_si256((const __m256i*)p);
+  /* '\t'..'\r' is a contiguous range: (c - 9) <= 4 unsigned. */
+  __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+  __m256i ctrl = _mm256_cmpeq_epi8(
+      _mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted);
+  __m256i punct = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')'))));
+  __m256i comment =
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('#')),
+                      _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+  __m256i newline = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+  __m256i delim = _mm256_or_si256(_mm256_or_si256(ctrl, punct), comment);
+
+  m->delim = (uint32_t)_mm256_movemask_epi8(delim);
+  m->newline = (uint32_t)_mm256_movemask_epi8(newline);
+  m->comment = (uint32_t)_mm256_movemask_epi8(comment);
+}
+#elif defined(__SSE2__)
+/* Classify SCAN_WIDTH bytes with SSE2. */
+static void classify_block(const char* p, ScanMasks* m) {
+  __m128i v = _mm_loadu_si128((const __m128i*)p);
+  /* '\t'..'\r' is a contiguous range: (c - 9) <= 4 unsigned. */
+  __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(9));
+  __m128i ctrl =
+      _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+  __m128i punct =
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8(','))),
+                   _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('(')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8(')'))));
+  __m128i comment = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('#')),
+                                 _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+  __m128i newline = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+  __m128i delim = _mm_or_si128(_mm_or_si128(ctrl, punct), comment);
+
+  m->delim = (uint32_t)_mm_movemask_epi8(delim);
+  m->newline = (uint32_t)_mm_movemask_epi8(newline);
+  m->comment = (uint32_t)_mm_movemask_epi8(comment);
+}
+#else
+static void classify_block(const char* p, ScanMasks* m) {
+  classify_scalar(p, SCAN_WIDTH, m);
+}
+#endif
+
+static int push_token(TokenList* list, size_t offset, size_t len,
+                      uint32_t line) {
+  if (list->len == list->cap) {
+    size_t new_cap = list->cap ? list->cap * 2 : INITIAL_TOKEN_CAP;
+    Token* tokens = realloc(list->tokens, new_cap * sizeof(Token));
+    if (!tokens) {
+      return -1;
+    }
+    list->tokens = tokens;
+    list->cap = new_cap;
+  }
+  Token* token = &list->tokens[list->len++];
+  token->offset = (uint32_t)offset;
+  token->len = (uint32_t)len;
+  token->line = line;
+  return 0;
+}
+
+/*******************************
+ * Scanner
+ *******************************/
+
+int scan_tokens(const char* data, size_t len, TokenList* out) {
+  out->tokens = NULL;
+  out->len = 0;
+  out->cap = 0;
+  out->num_lines = 0;
+  if (len > UINT32_MAX) {
+    return -1;
+  }
+
+  uint32_t line = 1;
+  int in_token = 0;
+  int in_comment = 0;
+  size_t token_start = 0;
+  /* Whether the byte before the current block is a delimiter. The start of
+     the buffer counts as one. */
+  uint64_t prev_delim = 1;
+
+  for (size_t pos = 0; pos < len; pos += SCAN_WIDTH) {
+    size_t n = len - pos < SCAN_WIDTH ? len - pos : SCAN_WIDTH;
+    ScanMasks m;
+    if (n == SCAN_WIDTH) {
+      classify_block(data + pos, &m);
+    } else {
+      classify_scalar(data + pos, n, &m);
+    }
+    uint64_t valid = n == 64 ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+    uint64_t word = ~m.delim & valid;
+
+    /* A token starts at a word byte after a delimiter and ends at the first
+       delimiter after a word byte. */
+    uint64_t starts = word & ((m.delim << 1) | prev_delim);
+    uint64_t ends = m.delim & ((word << 1) | (prev_delim ^ 1));
+    uint64_t events = starts | ends | m.newline | m.comment;
+    prev_delim = (m.delim >> (n - 1)) & 1;
+
+    while (events) {
+      if (in_comment) {
+        /* Skip to the newline that ends the comment, if it is in this
+           block. */
+        uint64_t newlines = events & m.newline;
+        if (!newlines) {
+          break;
+        }
+        events &= ~((newlines & (0 - newlines)) - 1);
+      }
+
+      int bit = __builtin_ctzll(events);
+      uint64_t mask = (uint64_t)1 << bit;
+      size_t at = pos + (size_t)bit;
+      events &= events - 1;
+
+      if ((ends & mask) && in_token) {
+        if (push_token(out, token_start, at - token_start, line) != 0) {
+          free_token_list(out);
+          return -1;
+        }
+        in_token = 0;
+      }
+      if (starts & mask) {
+        in_token = 1;
+        token_start = at;
+      }
+      if (m.comment & mask) {
+        in_comment = 1;
+      }
+      if (m.newline & mask) {
+        in_comment = 0;
+        line++;
+      }
+    }
+  }
+
+  if (in_token && push_token(out, token_start, len - token_start, line) != 0) {
+    free_token_list(out);
+    return -1;
+  }
+  /* A final line without a newline still counts. */
+  out->num_lines = (len > 0 && data[len - 1] != '\n') ? line : line - 1;
+  return 0;
+}
+
+void free_token_list(TokenList* list) {
+  free(list->tokens);
+  list->tokens = NULL;
+  list->len = 0;
+  list->cap = 0;
+}
@@ -0,0 +1,45 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* A token found by scan_tokens(): LEN bytes starting at OFFSET in the
+   scanned buffer, on source line LINE (first line is 1). */
+typedef struct {
+  uint32_t offset;
+  uint32_t len;
+  uint32_t line;
+} Token;
+
+/* Every token of a buffer, in order, plus the number of source lines. */
+typedef struct {
+  Token* tokens;
+  size_t len;
+  size_t cap;
+  uint32_t num_lines;
+} TokenList;
+
+/* Splits DATA into lines and tokens in a single pass.
+
+   The result matches what pass_one() gets from skip_comments() followed by
+   strtok(line, IGNORE_CHARS) on every line: tokens are separated by any of
+   " \f\n\r\t\v,()", and a '#' (or a NUL byte) ends the line's content.
+
+   Bytes are classified 32 (AVX2) or 16 (SSE2) at a time when the compiler
+   targets those instruction sets, otherwise through a lookup table.
+
+   Returns 0 on success, -1 if LEN does not fit the 32-bit offsets or an
+   allocation fails. OUT must be released with free_token_list().
+ */
+int scan_tokens(const char* data, size_t len, TokenList* out);
+
+void free_token_list(TokenList* list);
+
+#endif
@@ -0,0 +1,382 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#include "schedule.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "translate.h"
+
+/* Longest run scheduled at once; longer ones are split, which bounds the
+   quadratic dependence graph. */
+#define MAX_REGION 128
+
+static const PipelineModel models[] = {
+    /* IF ID EX MEM WB with forwarding: one bubble after a load, a
+       pipelined three-cycle multiplier and an iterative divider. */
+    {"5stage", 1, 2, 3, 34},
+    /* Two more stages between issue and memory, and a slower multiplier. */
+    {"7stage", 1, 3, 5, 34},
+};
+
+typedef enum { MEM_NONE, MEM_LOAD, MEM_STORE } MemAccess;
+
+/* One instruction, or a pair that is kept together, in a run. */
+typedef struct {
+  uint32_t first; /* index of its first entry in the program */
+  uint8_t size;   /* entries */
+  uint8_t latency;
+  uint8_t mem;    /* MemAccess */
+  uint32_t defs;  /* registers written, one bit each; x0 is left out */
+  uint32_t uses;  /* registers read */
+} SchedUnit;
+
+typedef struct {
+  IrProgram* prog;
+  const PipelineModel* model;
+  /* prog->code; op is IR_INVALID for an entry that did not decode. */
+  IrInstr* code;
+  /* Set for entries a label (or a numeric branch offset) points at. */
+  uint8_t* labeled;
+
+  /* The run being scheduled. lat[i][j] is the number of cycles unit J has
+     to issue after the last entry of unit I, or 0 if J does not depend on
+     I. */
+  SchedUnit units[MAX_REGION];
+  uint32_t num_units;
+  uint8_t lat[MAX_REGION][MAX_REGION];
+  uint32_t order[MAX_REGION];
+  IrInstr scratch[MAX_REGION];
+  IrSource scratch_sources[MAX_REGION];
+} Scheduler;
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+const PipelineModel* find_pipeline_model(const char* name) {
+  for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++) {
+    if (strcmp(name, models[i].name) == 0) {
+      return &models[i];
+    }
+  }
+  return NULL;
+}
+
+/* Index of the instruction a numeric branch or jump at INDEX reaches, or -1
+   if it is not one of the program's. */
+static int64_t numeric_target(const Scheduler* s, uint32_t index) {
+  const IrInstr* ir = &s->code[index];
+  int jump = (ir->op >= INSTR_BEQ && ir->op <= INSTR_BGEU) ||
+             ir->op == INSTR_JAL;
+  if (!jump || ir->sym != IR_NO_SYMBOL || ir->imm % 4 != 0) {
+    return -1;
+  }
+  int64_t target = (int64_t)index + ir->imm / 4;
+  return target >= 0 && target <= s->prog->len ? target : -1;
+}
+
+/* Whether entries A and B = A + 1 are the auipc and load of a `lw rd
+   label`. Both resolve the label relative to the auipc's address in pass
+   two, so the pair may move as long as it stays together. */
+static int is_label_load(const Scheduler* s, uint32_t a) {
+  const IrInstr* first = &s->code[a];
+  const IrInstr* second = &s->code[a + 1];
+  return first->op == INSTR_AUIPC && first->sym != IR_NO_SYMBOL &&
+         first->rd != 0 && second->op >= INSTR_LB && second->op <= INSTR_LHU &&
+         second->sym != IR_NO_SYMBOL && second->rs1 == first->rd &&
+         !s->labeled[a + 1];
+}
+
+/* Whether entries A and B = A + 1 are a pair to keep together: the
+   lui/addi of a `li`, or the auipc and load of a `lw rd label`. */
+static int is_fused(const Scheduler* s, uint32_t a) {
+  const IrInstr* first = &s->code[a];
+  const IrInstr* second = &s->code[a + 1];
+  if (first->op == INSTR_LUI) {
+    return first->rd != 0 && !s->labeled[a + 1] &&
+           second->op == INSTR_ADDI && second->rd == first->rd &&
+           second->rs1 == first->rd;
+  }
+  return is_label_load(s, a);
+}
+
+/* Branches, jumps, ecall and lines that do not decode stay where they
+   are, and end a run. So does any other auipc, whose result is its own
+   address (it may be used by a jalr or by hand-written address
+   arithmetic), and a load that names a label without its auipc. */
+static int is_barrier(const Scheduler* s, uint32_t index) {
+  const IrInstr* ir = &s->code[index];
+  if (ir->op == INSTR_AUIPC) {
+    return index + 1 >= s->prog->len || !is_label_load(s, index);
+  }
+  if (ir->sym != IR_NO_SYMBOL && ir->op >= INSTR_LB && ir->op <= INSTR_LHU) {
+    return index == 0 || !is_label_load(s, index - 1);
+  }
+  return ir->op == IR_INVALID || ir->op == INSTR_JALR ||
+         ir->op == INSTR_ECALL || ir->op == INSTR_JAL ||
+         (ir->op >= INSTR_BEQ && ir->op <= INSTR_BGEU);
+}
+
+/* Registers entry INDEX writes and reads, from its format. */
+static void def_use(const Scheduler* s, uint32_t index, uint32_t* defs,
+                    uint32_t* uses) {
+  const IrInstr* ir = &s->code[index];
+  const InstrInfo* info = instr_info((InstrId)ir->op);
+  *defs = 0;
+  *uses = 0;
+  switch (info->instr_type) {
+    case R_TYPE:
+      *defs = 1u << ir->rd;
+      *uses = (1u << ir->rs1) | (1u << ir->rs2);
+      break;
+    case I_TYPE:
+      *defs = 1u << ir->rd;
+      *uses = 1u << ir->rs1;
+      break;
+    case S_TYPE:
+    case SB_TYPE:
+      *uses = (1u << ir->rs1) | (1u << ir->rs2);
+      break;
+    case U_TYPE:
+    case UJ_TYPE:
+      *defs = 1u << ir->rd;
+      break;
+  }
+  *defs &= ~1u;
+  *uses &= ~1u;
+}
+
+/* Cycles before the result of entry INDEX can be used. */
+static uint8_t result_latency(const Scheduler* s, uint32_t index) {
+  uint8_t op = s->code[index].op;
+  if (op >= INSTR_LB && op <= INSTR_LHU) {
+    return s->model->load;
+  }
+  if (op == INSTR_MUL || op == INSTR_MULH) {
+    return s->model->mul;
+  }
+  if (op == INSTR_DIV || op == INSTR_REM) {
+    return s->model->div;
+  }
+  return s->model->alu;
+}
+
+static void add_unit(Scheduler* s, uint32_t first, uint8_t size) {
+  SchedUnit* unit = &s->units[s->num_units++];
+  unit->first = first;
+  unit->size = size;
+  unit->defs = 0;
+  unit->uses = 0;
+  unit->mem = MEM_NONE;
+  for (uint32_t i = first; i < first + size; i++) {
+    uint32_t defs, uses;
+    def_use(s, i, &defs, &uses);
+    /* The second of a pair reads what the first wrote. */
+    unit->uses |= uses & ~unit->defs;
+    unit->defs |= defs;
+    uint8_t op = s->code[i].op;
+    if (op >= INSTR_LB && op <= INSTR_LHU) {
+      unit->mem = MEM_LOAD;
+    } else if (op >= INSTR_SB && op <= INSTR_SW) {
+      unit->mem = MEM_STORE;
+    }
+    unit->latency = result_latency(s, i);
+  }
+}
+
+/* Fills in s->lat for the units of the run. */
+static void build_dependences(Scheduler* s) {
+  for (uint32_t i = 0; i < s->num_units; i++) {
+    const SchedUnit* a = &s->units[i];
+    for (uint32_t j = 0; j < s->num_units; j++) {
+      const SchedUnit* b = &s->units[j];
+      uint8_t lat = 0;
+      if (j > i) {
+        if (a->defs & b->uses) {
+          lat = a->latency;
+        } else if ((a->uses & b->defs) || (a->defs & b->defs) ||
+                   (a->mem == MEM_STORE && b->mem != MEM_NONE) ||
+                   (a->mem == MEM_LOAD && b->mem == MEM_STORE)) {
+          lat = 1;
+        }
+      }
+      s->lat[i][j] = lat;
+    }
+  }
+}
+
+/* Cycles the units of the run take, issued in s->order. */
+static uint32_t count_cycles(const Scheduler* s) {
+  uint32_t issued[MAX_REGION];
+  uint32_t cycle = 0;
+  for (uint32_t k = 0; k < s->num_units; k++) {
+    uint32_t u = s->order[k];
+    uint32_t start = cycle;
+    for (uint32_t p = 0; p < u; p++) {
+      /* Every unit a unit depends on comes before it in any valid order. */
+      if (s->lat[p][u] && issued[p] + s->lat[p][u] > start) {
+        start = issued[p] + s->lat[p][u];
+      }
+    }
+    issued[u] = start + s->units[u].size - 1;
+    cycle = start + s->units[u].size;
+  }
+  return cycle;
+}
+
+/* Sets s->order to a list schedule of the run: at each step, of the units
+   whose predecessors have issued, the one that can issue soonest, and of
+   those the one with the longest latency path to the end of the run. */
+static void list_schedule(Scheduler* s) {
+  uint32_t n = s->num_units;
+  uint32_t priority[MAX_REGION];
+  uint32_t waiting[MAX_REGION];
+  uint32_t earliest[MAX_REGION];
+  uint8_t done[MAX_REGION];
+  for (uint32_t i = n; i-- > 0;) {
+    uint32_t longest = 1;
+    waiting[i] = 0;
+    earliest[i] = 0;
+    done[i] = 0;
+    for (uint32_t j = i + 1; j < n; j++) {
+      if (s->lat[i][j] && s->lat[i][j] + priority[j] > longest) {
+        longest = s->lat[i][j] + priority[j];
+      }
+    }
+    for (uint32_t p = 0; p < i; p++) {
+      waiting[i] += s->lat[p][i] != 0;
+    }
+    priority[i] = s->units[i].size - 1 + longest;
+  }
+
+  uint32_t cycle = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    uint32_t best = n;
+    uint32_t best_start = 0;
+    for (uint32_t u = 0; u < n; u++) {
+      if (done[u] || waiting[u]) {
+        continue;
+      }
+      uint32_t start = earliest[u] > cycle ? earliest[u] : cycle;
+      if (best == n || start < best_start ||
+          (start == best_start && priority[u] > priority[best])) {
+        best = u;
+        best_start = start;
+      }
+    }
+    done[best] = 1;
+    s->order[k] = best;
+    uint32_t last = best_start + s->units[best].size - 1;
+    cycle = last + 1;
+    for (uint32_t j = best + 1; j < n; j++) {
+      if (s->lat[best][j]) {
+        waiting[j]--;
+        if (last + s->lat[best][j] > earliest[j]) {
+          earliest[j] = last + s->lat[best][j];
+        }
+      }
+    }
+  }
+}
+
+/* Schedules entries [START, END) of the program. Returns the cycles saved. */
+static uint32_t schedule_run(Scheduler* s, uint32_t start, uint32_t end) {
+  s->num_units = 0;
+  for (uint32_t i = start; i < end;) {
+    uint8_t size = i + 1 < end && is_fused(s, i) ? 2 : 1;
+    add_unit(s, i, size);
+    i += size;
+  }
+  if (s->num_units < 2) {
+    return 0;
+  }
+  build_dependences(s);
+  for (uint32_t i = 0; i < s->num_units; i++) {
+    s->order[i] = i;
+  }
+  uint32_t before = count_cycles(s);
+  list_schedule(s);
+  uint32_t after = count_cycles(s);
+  if (after >= before) {
+    return 0;
+  }
+
+  IrInstr* code = s->code;
+  IrSource* sources = s->prog->sources;
+  memcpy(s->scratch, &code[start], (end - start) * sizeof(IrInstr));
+  memcpy(s->scratch_sources, &sources[start],
+         (end - start) * sizeof(IrSource));
+  uint32_t dst = start;
+  for (uint32_t k = 0; k < s->num_units; k++) {
+    const SchedUnit* unit = &s->units[s->order[k]];
+    for (uint32_t i = 0; i < unit->size; i++) {
+      code[dst] = s->scratch[unit->first - start + i];
+      sources[dst] = s->scratch_sources[unit->first - start + i];
+      dst++;
+    }
+  }
+  return before - after;
+}
+
+/*******************************
+ * Scheduling
+ *******************************/
+
+uint32_t schedule_program(IrProgram* prog, SymbolTable* table,
+                          const PipelineModel* model) {
+  if (prog->len == 0) {
+    return 0;
+  }
+  Scheduler* s = malloc(sizeof(Scheduler));
+  uint8_t* labeled = calloc((size_t)prog->len + 1, 1);
+  if (!s || !labeled) {
+    free(s);
+    free(labeled);
+    allocation_failed();
+  }
+  s->prog = prog;
+  s->model = model;
+  s->code = prog->code;
+  s->labeled = labeled;
+  for (uint32_t i = 0; i < table->len; i++) {
+    uint32_t index = table->entries[i].addr / 4;
+    if (index <= prog->len) {
+      labeled[index] = 1;
+    }
+  }
+  for (uint32_t i = 0; i < prog->len; i++) {
+    int64_t target = numeric_target(s, i);
+    if (target >= 0) {
+      labeled[target] = 1;
+    }
+  }
+
+  uint32_t saved = 0;
+  uint32_t i = 0;
+  while (i < prog->len) {
+    if (is_barrier(s, i)) {
+      i++;
+      continue;
+    }
+    uint32_t end = i + 1;
+    while (end < prog->len && end - i < MAX_REGION && !labeled[end] &&
+           !is_barrier(s, end)) {
+      end++;
+    }
+    /* Keep a pair that the limit splits out of the run. */
+    if (end - i > 1 && end < prog->len && !labeled[end] &&
+        is_fused(s, end - 1)) {
+      end--;
+    }
+    saved += schedule_run(s, i, end);
+    i = end;
+  }
+  free(s);
+  free(labeled);
+  return saved;
+}
@@ -0,0 +1,47 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdint.h>
+
+#include "ir.h"
+#include "tables.h"
+
+/* Timing of a single-issue, in-order pipeline: the number of cycles from
+   issuing an instruction until one that uses its result can issue without
+   stalling. 1 is back to back, through forwarding. */
+typedef struct {
+  const char* name;
+  uint8_t alu;
+  uint8_t load;
+  uint8_t mul; /* mul, mulh */
+  uint8_t div; /* div, rem */
+} PipelineModel;
+
+/* Returns the model called NAME, or NULL if there is none. */
+const PipelineModel* find_pipeline_model(const char* name);
+
+/* Reorders the instructions of PROG, after pass one, to hide load-use and
+   multiply/divide latencies on MODEL.
+
+   Only the straight-line runs between labels (and targets of numeric
+   branch offsets) and branches, jumps, ecalls, auipcs and lines that do
+   not decode are reordered, so labels, control flow and the addresses
+   auipc captures stay where they are and TABLE is left alone. Within a
+   run, an instruction only moves past another if neither writes a
+   register the other uses, and stores keep their order with other loads
+   and stores. The lui/addi of a `li` and the auipc/load of a `lw rd
+   label` move as one.
+
+   Each run is list scheduled by the longest latency path to its end, and
+   only rewritten if that takes fewer cycles on MODEL than the source
+   order. Returns the number of stall cycles saved. */
+uint32_t schedule_program(IrProgram* prog, SymbolTable* table,
+                          const PipelineModel* model);
+
+#endif
@@ -0,0 +1,153 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "source.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "block.h"
+
+int source_map(SourceMap* src, FILE* file) {
+  struct stat st;
+  int fd = fileno(file);
+
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+      st.st_size <= 0) {
+    return -1;
+  }
+
+  void* data =
+      mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    return -1;
+  }
+#ifdef POSIX_MADV_SEQUENTIAL
+  posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+  src->data = data;
+  src->len = (size_t)st.st_size;
+  src->mapped = 1;
+  src->line = NULL;
+  src->line_cap = 0;
+  return 0;
+}
+
+void source_view(SourceMap* src, const char* data, size_t len) {
+  src->data = data;
+  src->len = len;
+  src->mapped = 0;
+  src->line = NULL;
+  src->line_cap = 0;
+}
+
+char* source_line(SourceMap* src, size_t size) {
+  if (size > src->line_cap) {
+    size_t cap = size > 2 * src->line_cap ? size : 2 * src->line_cap;
+    char* line = realloc(src->line, cap);
+    if (!line) {
+      block_allocation_failed();
+    }
+    src->line = line;
+    src->line_cap = cap;
+  }
+  return src->line;
+}
+
+void source_unmap(SourceMap* src) {
+  if (src->mapped) {
+    munmap((void*)src->data, src->len);
+  }
+  free(src->line);
+  src->data = NULL;
+  src->len = 0;
+  src->mapped = 0;
+  src->line = NULL;
+  src->line_cap = 0;
+}
+
+/* Reads more input into READER's buffer after the unread part. Returns 0
+   if anything was read, -1 at the end of the input or on an error. */
+static int fill_line_reader(LineReader* reader) {
+  if (reader->start > 0) {
+    memmove(reader->buf, reader->buf + reader->start,
+            reader->end - reader->start);
+    reader->end -= reader->start;
+    reader->start = 0;
+  }
+  if (reader->flush) {
+    struct pollfd pfd = {reader->fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) == 0) {
+      writer_flush(reader->flush);
+    }
+  }
+  for (;;) {
+    ssize_t n = read(reader->fd, reader->buf + reader->end,
+                     LINE_READER_BUF_SIZE - reader->end);
+    if (n > 0) {
+      reader->end += (size_t)n;
+      return 0;
+    }
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    reader->eof = 1;
+    return -1;
+  }
+}
+
+void line_reader_init(LineReader* reader, int fd, OutputWriter* flush) {
+  reader->fd = fd;
+  reader->buf = malloc(LINE_READER_BUF_SIZE);
+  if (!reader->buf) {
+    block_allocation_failed();
+  }
+  reader->start = 0;
+  reader->end = 0;
+  reader->eof = 0;
+  reader->flush = flush;
+}
+
+void line_reader_release(LineReader* reader) {
+  free(reader->buf);
+  reader->buf = NULL;
+}
+
+char* line_reader_gets(LineReader* reader, char* buf, int size) {
+  size_t max = size > 1 ? (size_t)size - 1 : 0;
+  for (;;) {
+    size_t avail = reader->end - reader->start;
+    size_t scan = avail < max ? avail : max;
+    const char* data = reader->buf + reader->start;
+    const char* newline = memchr(data, '\n', scan);
+    size_t len = 0;
+    if (newline) {
+      len = (size_t)(newline - data) + 1;
+    } else if (avail >= max || (reader->eof && avail > 0)) {
+      len = scan;
+    } else if (reader->eof) {
+      return NULL;
+    }
+    if (len > 0) {
+      memcpy(buf, data, len);
+      buf[len] = '\0';
+      reader->start += len;
+      return buf;
+    }
+    /* A line longer than the buffer is cut by MAX first, so there is
+       always room to read more here. */
+    fill_line_reader(reader);
+  }
+}
@@ -0,0 +1,84 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "writer.h"
+
+/* Bytes a LineReader asks read() for at a time. */
+#define LINE_READER_BUF_SIZE (64 * 1024)
+
+/* A source file mapped into memory, or a source already in memory.
+
+   The mapping is read-only: pass one copies each line's tokens out of it
+   into LINE (see source_line()), so no page of the file is ever written to
+   or duplicated.
+ */
+typedef struct {
+  /* Start of the mapping. */
+  const char* data;
+  /* Size of the file in bytes. */
+  size_t len;
+  /* DATA was mapped by source_map() rather than set by source_view(). */
+  int mapped;
+  /* Scratch space for one line's tokens, LINE_CAP bytes. */
+  char* line;
+  size_t line_cap;
+} SourceMap;
+
+/* Map the regular file behind FILE into SRC. Returns 0 on success and -1 if
+   FILE is not a regular file, is empty, or cannot be mapped; the caller
+   should then read FILE as a stream. */
+int source_map(SourceMap* src, FILE* file);
+
+/* Make SRC refer to the LEN bytes at DATA, for sources that are already in
+   memory. Nothing is copied, so DATA must outlive SRC. */
+void source_view(SourceMap* src, const char* data, size_t len);
+
+/* Returns SRC's scratch line, grown to at least SIZE bytes. It lives until
+   source_unmap(), so that it is freed after an allocation failure too. */
+char* source_line(SourceMap* src, size_t size);
+
+/* Unmap SRC if it was mapped, free its scratch line, and reset it. */
+void source_unmap(SourceMap* src);
+
+/* Reads a file descriptor line by line, like fgets() on a FILE, in
+   LINE_READER_BUF_SIZE reads.
+
+   Unlike stdio it knows when the next read() would have to wait for the
+   writer at the other end of a pipe, and flushes FLUSH first. A pipeline
+   such as `gen | assembler --input_file - --stdout | consumer` thus passes
+   on every instruction that could be encoded from what the generator has
+   written so far, without a write() per instruction while input is
+   plentiful.
+ */
+typedef struct {
+  int fd;
+  char* buf;
+  /* Unread input is buf[start, end). */
+  size_t start;
+  size_t end;
+  int eof;
+  /* Flushed before a read() that would block; may be NULL. */
+  OutputWriter* flush;
+} LineReader;
+
+/* Initialize READER to read FD. FD is not closed by the reader. */
+void line_reader_init(LineReader* reader, int fd, OutputWriter* flush);
+
+void line_reader_release(LineReader* reader);
+
+/* Like fgets(BUF, SIZE, stream): copies the next line, newline included,
+   into BUF, cut after SIZE - 1 bytes (the rest is the next "line"), and
+   NUL-terminates it. Returns NULL at the end of the input or on a read
+   error. */
+char* line_reader_gets(LineReader* reader, char* buf, int size);
+
+#endif
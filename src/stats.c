@@ -0,0 +1,221 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char* const phase_names[NUM_PHASES] = {
+    [PHASE_READ] = "read",
+    [PHASE_PASS_ONE] = "pass_one",
+    [PHASE_PASS_TWO] = "pass_two",
+    [PHASE_WRITE] = "write",
+    [PHASE_DUMP] = "dump",
+};
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+static double clock_seconds(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Prints STR as a JSON string. */
+static void write_json_string(FILE* output, const char* str) {
+  fputc('"', output);
+  for (const unsigned char* p = (const unsigned char*)str; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      fprintf(output, "\\%c", *p);
+    } else if (*p < 0x20) {
+      fprintf(output, "\\u%04x", *p);
+    } else {
+      fputc(*p, output);
+    }
+  }
+  fputc('"', output);
+}
+
+static void write_text(FILE* output, const AssembleStats* stats,
+                       const char* name) {
+  fprintf(output, "Statistics for %s\n", name);
+  fprintf(output, "  %-10s %12s %12s\n", "phase", "wall ms", "cpu ms");
+  PhaseTime total = {0, 0};
+  for (int i = 0; i < NUM_PHASES; i++) {
+    fprintf(output, "  %-10s %12.3f %12.3f\n", phase_names[i],
+            stats->phases[i].wall * 1e3, stats->phases[i].cpu * 1e3);
+    total.wall += stats->phases[i].wall;
+    total.cpu += stats->phases[i].cpu;
+  }
+  fprintf(output, "  %-10s %12.3f %12.3f\n", "total", total.wall * 1e3,
+          total.cpu * 1e3);
+  fprintf(output, "  lines            %" PRIu64 "\n", stats->lines);
+  fprintf(output, "  instructions     %" PRIu64 "\n", stats->instructions);
+  fprintf(output, "  labels           %" PRIu64 "\n", stats->labels);
+  fprintf(output, "  errors           %" PRIu64 "\n", stats->errors);
+  fprintf(output, "  eliminated       %" PRIu64 "\n", stats->eliminated);
+  fprintf(output, "  pseudo-expansions\n");
+  for (int i = 0; i < NUM_PSEUDOS; i++) {
+    fprintf(output, "    %-6s %" PRIu64 "\n", pseudo_handler_name(i),
+            stats->pseudo_expansions[i]);
+  }
+  fprintf(output, "  block capacity   %" PRIu64 "\n", stats->block_cap);
+  fprintf(output, "  table capacity   %" PRIu64 "\n", stats->table_cap);
+  fprintf(output, "  bytes allocated  %" PRIu64 "\n", stats->bytes_allocated);
+}
+
+static void write_json(FILE* output, const AssembleStats* stats,
+                       const char* name) {
+  fprintf(output, "{\"input\": ");
+  write_json_string(output, name);
+  fprintf(output, ", \"phases\": {");
+  for (int i = 0; i < NUM_PHASES; i++) {
+    fprintf(output, "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}",
+            i ? ", " : "", phase_names[i], stats->phases[i].wall * 1e3,
+            stats->phases[i].cpu * 1e3);
+  }
+  fprintf(output,
+          "}, \"lines\": %" PRIu64 ", \"instructions\": %" PRIu64
+          ", \"labels\": %" PRIu64 ", \"errors\": %" PRIu64
+          ", \"eliminated\": %" PRIu64 ", \"pseudo_expansions\": {",
+          stats->lines, stats->instructions, stats->labels, stats->errors,
+          stats->eliminated);
+  for (int i = 0; i < NUM_PSEUDOS; i++) {
+    fprintf(output, "%s\"%s\": %" PRIu64, i ? ", " : "",
+            pseudo_handler_name(i), stats->pseudo_expansions[i]);
+  }
+  fprintf(output,
+          "}, \"block_cap\": %" PRIu64 ", \"table_cap\": %" PRIu64
+          ", \"bytes_allocated\": %" PRIu64 "}\n",
+          stats->block_cap, stats->table_cap, stats->bytes_allocated);
+}
+
+/*******************************
+ * Stats Functions
+ *******************************/
+
+void phase_time_now(PhaseTime* time) {
+  time->wall = clock_seconds(CLOCK_MONOTONIC);
+  time->cpu = clock_seconds(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void phase_time_add_since(PhaseTime* total, const PhaseTime* start) {
+  PhaseTime end;
+  phase_time_now(&end);
+  total->wall += end.wall - start->wall;
+  total->cpu += end.cpu - start->cpu;
+}
+
+void stats_init(AssembleStats* stats) { memset(stats, 0, sizeof(*stats)); }
+
+void stats_start(const AssembleStats* stats, PhaseTimer* timer) {
+  if (stats) {
+    phase_time_now(&timer->start);
+    timer->write = stats->phases[PHASE_WRITE];
+  }
+}
+
+void stats_stop(AssembleStats* stats, Phase phase, const PhaseTimer* timer) {
+  if (!stats) {
+    return;
+  }
+  PhaseTime end;
+  phase_time_now(&end);
+  PhaseTime* write = &stats->phases[PHASE_WRITE];
+  stats->phases[phase].wall +=
+      end.wall - timer->start.wall - (write->wall - timer->write.wall);
+  stats->phases[phase].cpu +=
+      end.cpu - timer->start.cpu - (write->cpu - timer->write.cpu);
+}
+
+void stats_note_block(AssembleStats* stats, const Block* blk) {
+  if (!stats || !blk) {
+    return;
+  }
+  if (blk->cap > stats->block_cap) {
+    stats->block_cap = blk->cap;
+  }
+  uint64_t bytes = sizeof(Block) + (uint64_t)blk->cap * sizeof(Instr) +
+                   (uint64_t)blk->strings.interned_cap * sizeof(char*);
+  for (const ArenaChunk* chunk = blk->strings.head; chunk;
+       chunk = chunk->next) {
+    bytes += sizeof(ArenaChunk) + chunk->cap;
+  }
+  stats->bytes_allocated += bytes;
+}
+
+void stats_note_table(AssembleStats* stats, const SymbolTable* table) {
+  if (!stats || !table) {
+    return;
+  }
+  if (table->cap > stats->table_cap) {
+    stats->table_cap = table->cap;
+  }
+  uint64_t bytes = sizeof(SymbolTable) +
+                   (uint64_t)table->cap * sizeof(Symbol) +
+                   (uint64_t)table->index_cap * sizeof(uint32_t);
+  for (uint32_t i = 0; i < table->len; i++) {
+    bytes += strlen(table->entries[i].name) + 1;
+  }
+  stats->bytes_allocated += bytes;
+}
+
+void stats_note_tokens(AssembleStats* stats, const TokenList* tokens) {
+  if (stats) {
+    stats->bytes_allocated += (uint64_t)tokens->cap * sizeof(Token);
+  }
+}
+
+void stats_note_ir(AssembleStats* stats, const IrProgram* prog) {
+  if (!stats) {
+    return;
+  }
+  uint64_t bytes =
+      (uint64_t)prog->cap * (sizeof(IrInstr) + sizeof(IrSource)) +
+      (uint64_t)prog->refs_cap * (sizeof(const char*) + sizeof(int64_t)) +
+      (uint64_t)prog->ref_index_cap * sizeof(uint32_t) +
+      (uint64_t)prog->strings.interned_cap * sizeof(char*);
+  for (const ArenaChunk* chunk = prog->strings.head; chunk;
+       chunk = chunk->next) {
+    bytes += sizeof(ArenaChunk) + chunk->cap;
+  }
+  stats->bytes_allocated += bytes;
+}
+
+void stats_note_writer(AssembleStats* stats, const OutputWriter* writer) {
+  if (stats) {
+    stats->bytes_allocated += writer->cap;
+  }
+}
+
+void write_stats(FILE* output, const AssembleStats* stats, const char* name,
+                 int json) {
+  char* report = NULL;
+  size_t len = 0;
+  FILE* buffer = open_memstream(&report, &len);
+  /* Without memory for the buffer, print directly. */
+  FILE* target = buffer ? buffer : output;
+  if (json) {
+    write_json(target, stats, name);
+  } else {
+    write_text(target, stats, name);
+  }
+  if (buffer) {
+    fclose(buffer);
+    if (report) {
+      fwrite(report, 1, len, output);
+    }
+    free(report);
+  }
+  fflush(output);
+}
@@ -0,0 +1,97 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "block.h"
+#include "ir.h"
+#include "scan.h"
+#include "tables.h"
+#include "translate.h"
+#include "writer.h"
+
+/* The phases of one assembly that --stats times. */
+typedef enum {
+  PHASE_READ,     /* opening and mapping the input */
+  PHASE_PASS_ONE, /* tokenizing and pass_one() */
+  PHASE_PASS_TWO, /* decoding, resolving and encoding */
+  PHASE_WRITE,    /* handing the output to write(), and the ELF container */
+  PHASE_DUMP,     /* the .tbl and .inst files of --test */
+  NUM_PHASES,
+} Phase;
+
+/* Wall-clock and CPU seconds. The CPU time is the whole process's, so it
+   includes pass-two worker threads (and, in batch mode, the other files
+   assembled at the same time). */
+typedef struct PhaseTime {
+  double wall;
+  double cpu;
+} PhaseTime;
+
+/* Statistics of one assembly. */
+typedef struct {
+  PhaseTime phases[NUM_PHASES];
+
+  uint64_t lines;
+  uint64_t instructions;
+  uint64_t labels;
+  uint64_t errors;
+  /* Instructions removed by the peephole pass (-O). */
+  uint64_t eliminated;
+  /* Lines rewritten by each pseudo-instruction handler. */
+  uint64_t pseudo_expansions[NUM_PSEUDOS];
+
+  /* Largest capacity the Block and the SymbolTable reached. */
+  uint64_t block_cap;
+  uint64_t table_cap;
+  /* Bytes held by the assembler's data structures (block, string arena,
+     symbol table, tokens, IR and output buffers), each at its largest. */
+  uint64_t bytes_allocated;
+} AssembleStats;
+
+/* A phase being timed; see stats_start(). */
+typedef struct {
+  PhaseTime start;
+  /* PHASE_WRITE when the phase started. */
+  PhaseTime write;
+} PhaseTimer;
+
+/* Sets *TIME to the current wall-clock and CPU time. */
+void phase_time_now(PhaseTime* time);
+
+/* Adds the time since START, from phase_time_now(), to *TOTAL. */
+void phase_time_add_since(PhaseTime* total, const PhaseTime* start);
+
+void stats_init(AssembleStats* stats);
+
+/* Starts timing into TIMER. Does nothing if STATS is NULL. */
+void stats_start(const AssembleStats* stats, PhaseTimer* timer);
+
+/* Adds the time since stats_start() to PHASE. Output written meanwhile by a
+   writer whose io_time is &STATS->phases[PHASE_WRITE] has been counted as
+   PHASE_WRITE already and is left out. Does nothing if STATS is NULL. */
+void stats_stop(AssembleStats* stats, Phase phase, const PhaseTimer* timer);
+
+/* Record the size of each structure. They only grow, so calling these once
+   each, when the structure is at its largest, gives the peak. STATS may be
+   NULL. */
+void stats_note_block(AssembleStats* stats, const Block* blk);
+void stats_note_table(AssembleStats* stats, const SymbolTable* table);
+void stats_note_tokens(AssembleStats* stats, const TokenList* tokens);
+void stats_note_ir(AssembleStats* stats, const IrProgram* prog);
+void stats_note_writer(AssembleStats* stats, const OutputWriter* writer);
+
+/* Prints STATS for the input file NAME to OUTPUT, as a table or, if JSON is
+   set, as one JSON object on a line. The report is written in one go, so
+   that the reports of concurrent assemblies do not interleave. */
+void write_stats(FILE* output, const AssembleStats* stats, const char* name,
+                 int json);
+
+#endif
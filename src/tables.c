@@ -23,12 +23,16 @@ const int SYMBOLTBL_UNIQUE_NAME = 1;
    You should create test cases with lines shorter than MAX_LINE_LEN. */
 const int MAX_LINE_LEN = 256;
 
+/* Initial number of slots in the hash index. Must be a power of two. */
+#define INITIAL_INDEX_CAP 64
+
 /*******************************
  * Helper Functions
  *******************************/
 
 void allocation_failed(void) {
   write_to_log("Error: allocation failed\n");
+  recover_from_allocation_failure();
   exit(1);
 }
 
@@ -59,6 +63,14 @@ void write_sym(FILE* output, uint32_t addr, const char* name) {
 
  */
 SymbolTable* create_table(int mode) {
+  return create_table_with_capacity(mode, INCREMENT_OF_CAP);
+}
+
+/* Same as create_table(), but reserves room for CAP symbols (and sizes the
+   hash index to match) so that a caller that can estimate the number of
+   labels avoids resizing while the table fills up. CAP is only a hint.
+ */
+SymbolTable* create_table_with_capacity(int mode, uint32_t cap) {
   if (!(mode == SYMBOLTBL_NON_UNIQUE || mode == SYMBOLTBL_UNIQUE_NAME)) {
     return NULL;
   }
@@ -69,10 +81,24 @@ SymbolTable* create_table(int mode) {
   if (!tbl) allocation_failed();
   
   tbl->len = 0;
-  tbl->cap = INCREMENT_OF_CAP;
+  tbl->cap = cap > INCREMENT_OF_CAP ? cap : INCREMENT_OF_CAP;
   tbl->mode = mode;
   tbl->entries = malloc(sizeof(Symbol) * tbl->cap);
-  if (!tbl->entries) allocation_failed();
+  if (!tbl->entries) {
+    free(tbl);
+    allocation_failed();
+  }
+  /* Keep the index at most half full for CAP symbols. */
+  tbl->index_cap = INITIAL_INDEX_CAP;
+  while (tbl->index_cap < tbl->cap * 2) {
+    tbl->index_cap *= 2;
+  }
+  tbl->index = calloc(tbl->index_cap, sizeof(uint32_t));
+  if (!tbl->index) {
+    free(tbl->entries);
+    free(tbl);
+    allocation_failed();
+  }
   
   return tbl;
   /* === end === */
@@ -88,10 +114,20 @@ void free_table(SymbolTable* table) {
       free(table->entries[i].name);
   }
   free(table->entries);
+  free(table->index);
   free(table);
   /* === end === */
 }
 
+/* Empty TABLE. The entries array and the index keep their capacity. */
+void clear_table(SymbolTable* table) {
+  for (uint32_t i = 0; i < table->len; i++) {
+    free(table->entries[i].name);
+  }
+  table->len = 0;
+  memset(table->index, 0, table->index_cap * sizeof(uint32_t));
+}
+
 static char* strdup(const char* src) {
   if (!src) {
     return NULL;
@@ -105,6 +141,42 @@ static char* strdup(const char* src) {
   return dst;
 }
  
+/* Returns the index slot holding NAME, or the empty slot where NAME would be
+   inserted. The index is never full, so the probe always terminates. */
+static uint32_t* find_slot(SymbolTable* table, const char* name) {
+  uint32_t mask = table->index_cap - 1;
+  uint32_t pos = hash_string(name) & mask;
+  while (table->index[pos] != 0) {
+    if (strcmp(table->entries[table->index[pos] - 1].name, name) == 0) {
+      break;
+    }
+    pos = (pos + 1) & mask;
+  }
+  return &table->index[pos];
+}
+
+/* Doubles the hash index and reinserts every entry. For duplicate names
+   (SYMBOLTBL_NON_UNIQUE) only the first entry is indexed, matching the
+   first-match result of a linear scan. */
+static void grow_index(SymbolTable* table) {
+  /* The old index stays in place until the new one exists, so the table is
+     still usable (and freeable) if the allocation fails. */
+  uint32_t* new_index = calloc(table->index_cap * 2, sizeof(uint32_t));
+  if (!new_index) {
+    allocation_failed();
+  }
+  uint32_t* old_index = table->index;
+  table->index = new_index;
+  table->index_cap *= 2;
+  for (uint32_t i = 0; i < table->len; ++i) {
+    uint32_t* slot = find_slot(table, table->entries[i].name);
+    if (*slot == 0) {
+      *slot = i + 1;
+    }
+  }
+  free(old_index);
+}
+
 /* Search for a label with the given name in the table.
  * If the label is found, return a pointer to the corresponding Symbol struct.
  * If the label is not found, return NULL.
@@ -115,10 +187,9 @@ static Symbol* lookup(SymbolTable* table, const char* name) {
   }
   /* IMPLEMENT ME */
   /* === start === */
-  for (uint32_t i = 0; i < table->len; ++i) {
-    if (strcmp(table->entries[i].name, name) == 0) {
-      return &table->entries[i];
-    }
+  uint32_t slot = *find_slot(table, name);
+  if (slot != 0) {
+    return &table->entries[slot - 1];
   }
 
   /* === end === */
@@ -148,21 +219,19 @@ int add_to_table(SymbolTable* table, const char* name, uint32_t addr) {
       return -1;
   }
 
-  if (table->mode == SYMBOLTBL_UNIQUE_NAME) {
-      if (lookup(table, name) != NULL) {
-          name_already_exists(name);
-          return -1;
-      }
+  /* Keep the index at most half full so probe sequences stay short. */
+  if ((table->len + 1) * 2 > table->index_cap) {
+      grow_index(table);
+  }
+
+  uint32_t* slot = find_slot(table, name);
+  if (*slot != 0 && table->mode == SYMBOLTBL_UNIQUE_NAME) {
+      name_already_exists(name);
+      return -1;
   }
 
   if (table->len >= table->cap) {
-      size_t new_cap = table->cap + INCREMENT_OF_CAP;
-      Symbol* new_entries = realloc(table->entries, new_cap * sizeof(Symbol));
-      if (!new_entries) {
-          allocation_failed();
-      }
-      table->entries = new_entries;
-      table->cap = new_cap;
+      resize_table(table);
   }
 
   char* name_copy = strdup(name);
@@ -173,6 +242,9 @@ int add_to_table(SymbolTable* table, const char* name, uint32_t addr) {
   table->entries[table->len].name = name_copy;
   table->entries[table->len].addr = addr;
   table->len++;
+  if (*slot == 0) {
+      *slot = table->len;
+  }
   
   return 0;
 }
@@ -208,11 +280,14 @@ void write_table(SymbolTable* table, FILE* output) {
   }
 }
 
-/* Increase the capacity of the table by INCREMENT_OF_CAP */
+/* Double the capacity of the table, growing by at least INCREMENT_OF_CAP */
 void resize_table(SymbolTable* table) {
   /* IMPLEMENT ME */
   /* === start === */
-  size_t new_capacity = table->cap + INCREMENT_OF_CAP;
+  size_t new_capacity = (size_t)table->cap * 2;
+  if (new_capacity < (size_t)table->cap + INCREMENT_OF_CAP) {
+    new_capacity = (size_t)table->cap + INCREMENT_OF_CAP;
+  }
   
   // 重新分配内存空间
   Symbol* new_entries = realloc(table->entries, new_capacity * sizeof(Symbol));
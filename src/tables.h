@@ -10,7 +10,7 @@
 #include <stdint.h>
 #include <stdio.h>
 
-/* increment of capacity */
+/* initial capacity, and the minimum growth step */
 #define INCREMENT_OF_CAP 32
 
 /* Indicates whether unique labels are supported. */
@@ -31,6 +31,13 @@ typedef struct {
   /* === start === */
 Symbol* entries;
 
+  /* Open-addressing hash index over `entries`. Each slot holds an entry
+     index plus one, 0 marks an empty slot. `entries` keeps insertion order
+     for write_table(); the index only speeds up lookup(). */
+  uint32_t* index;
+  /* Number of slots in `index`, always a power of two. */
+  uint32_t index_cap;
+
   /* === end === */
 
   /* The current length of the table. */
@@ -50,9 +57,16 @@ void write_sym(FILE* output, uint32_t addr, const char* name);
 /* IMPLEMENT ME - see documentation in tables.c */
 SymbolTable* create_table(int mode);
 
+/* Like create_table(), with room for CAP symbols before the table grows. */
+SymbolTable* create_table_with_capacity(int mode, uint32_t cap);
+
 /* IMPLEMENT ME - see documentation in tables.c */
 void free_table(SymbolTable* table);
 
+/* Remove every symbol but keep the allocated memory, so the table can be
+   reused for another source. */
+void clear_table(SymbolTable* table);
+
 /* IMPLEMENT ME - see documentation in tables.c */
 void resize_table(SymbolTable* table);
 
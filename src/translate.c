@@ -16,12 +16,16 @@
 #include "translate_utils.h"
 
 
-static const PseudoHandler pseudo_handlers[] = {
-    {"beqz", transform_beqz}, {"bnez", transform_bnez}, {"li", transform_li},
-    {"mv", transform_mv},     {"j", transform_j},       {"jr", transform_jr},
-    {"jal", transform_jal},   {"jalr", transform_jalr}, {"lw", transform_lw},
+static const PseudoHandler pseudo_handlers[NUM_PSEUDOS] = {
+#define PSEUDO_HANDLER(id, name, key, transform) \
+  [PSEUDO_##id] = {name, transform},
+    PSEUDO_INSTRUCTIONS(PSEUDO_HANDLER)
+#undef PSEUDO_HANDLER
 };
 
+/* Expansion counters installed with count_pseudo_expansions(), or NULL. */
+static _Thread_local uint64_t* pseudo_counts = NULL;
+
 /* 
 Fields per entry:
   - const char* name;         -- instr name
@@ -30,70 +34,24 @@ Fields per entry:
   - uint8_t funct3;
   - uint8_t funct7;           -- funct7 or partial imm
   - ImmType imm_type;         -- imm type (see translate_utils.h)
+The entries are generated from RV32_INSTRUCTIONS in translate.h.
 */
-static const InstrInfo instr_table[] = {
-    // R-type instructions
-    {"add", R_TYPE, 0x33, 0x0, 0x00, IMM_NONE},
-
-    {"sub", R_TYPE, 0x33, 0x0, 0x20, IMM_NONE},
-    {"xor", R_TYPE, 0x33, 0x4, 0x00, IMM_NONE},
-    {"or", R_TYPE, 0x33, 0x6, 0x00, IMM_NONE},
-    {"and", R_TYPE, 0x33, 0x7, 0x00, IMM_NONE},
-    {"sll", R_TYPE, 0x33, 0x1, 0x00, IMM_NONE},
-    {"srl", R_TYPE, 0x33, 0x5, 0x00, IMM_NONE},
-    {"sra", R_TYPE, 0x33, 0x5, 0x20, IMM_NONE},
-    {"slt", R_TYPE, 0x33, 0x2, 0x00, IMM_NONE},
-    {"sltu", R_TYPE, 0x33, 0x3, 0x00, IMM_NONE},
-    {"mul", R_TYPE, 0x33, 0x0, 0x01, IMM_NONE},
-    {"mulh", R_TYPE, 0x33, 0x1, 0x01, IMM_NONE},
-    {"div", R_TYPE, 0x33, 0x4, 0x01, IMM_NONE},
-    {"rem", R_TYPE, 0x33, 0x6, 0x01, IMM_NONE},
-
-    // I-type instructions
-    {"addi", I_TYPE, 0x13, 0x0, 0x00, IMM_12_SIGNED},
-    {"xori", I_TYPE, 0x13, 0x4, 0x00, IMM_12_SIGNED},
-    {"ori", I_TYPE, 0x13, 0x6, 0x00, IMM_12_SIGNED},
-    {"andi", I_TYPE, 0x13, 0x7, 0x00, IMM_12_SIGNED},
-    {"slli", I_TYPE, 0x13, 0x1, 0x00, IMM_5_UNSIGNED},
-    {"srli", I_TYPE, 0x13, 0x5, 0x00, IMM_5_UNSIGNED},
-    {"srai", I_TYPE, 0x13, 0x5, 0x20, IMM_5_UNSIGNED},
-    {"slti", I_TYPE, 0x13, 0x2, 0x00, IMM_12_SIGNED},
-    {"sltiu", I_TYPE, 0x13, 0x3, 0x00, IMM_12_SIGNED},
-    {"lb", I_TYPE, 0x03, 0x0, 0x00, IMM_12_SIGNED},
-    {"lh", I_TYPE, 0x03, 0x1, 0x00, IMM_12_SIGNED},
-    {"lw", I_TYPE, 0x03, 0x2, 0x00, IMM_12_SIGNED},
-    {"lbu", I_TYPE, 0x03, 0x4, 0x00, IMM_12_SIGNED},
-    {"lhu", I_TYPE, 0x03, 0x5, 0x00, IMM_12_SIGNED},
-    {"jalr", I_TYPE, 0x67, 0x0, 0x00, IMM_12_SIGNED},
-    {"ecall", I_TYPE, 0x73, 0x0, 0x00, IMM_NONE},
-
-    // S-type instructions
-    {"sb", S_TYPE, 0x23, 0x0, 0x00, IMM_12_SIGNED},
-    {"sh", S_TYPE, 0x23, 0x1, 0x00, IMM_12_SIGNED},
-    {"sw", S_TYPE, 0x23, 0x2, 0x00, IMM_12_SIGNED},
-
-    // SB-type instructions
-    {"beq", SB_TYPE, 0x63, 0x0, 0x00, IMM_13_SIGNED},
-    {"bne", SB_TYPE, 0x63, 0x1, 0x00, IMM_13_SIGNED},
-    {"blt", SB_TYPE, 0x63, 0x4, 0x00, IMM_13_SIGNED},
-    {"bge", SB_TYPE, 0x63, 0x5, 0x00, IMM_13_SIGNED},
-    {"bltu", SB_TYPE, 0x63, 0x6, 0x00, IMM_13_SIGNED},
-    {"bgeu", SB_TYPE, 0x63, 0x7, 0x00, IMM_13_SIGNED},
-
-    // U-type instructions
-    {"lui", U_TYPE, 0x37, 0x0, 0x00, IMM_20_UNSIGNED},
-    {"auipc", U_TYPE, 0x17, 0x0, 0x00, IMM_20_UNSIGNED},
-
-    // UJ-type instructions
-    {"jal", UJ_TYPE, 0x6f, 0x0, 0x00, IMM_21_SIGNED},
+static const InstrInfo instr_table[NUM_INSTRS] = {
+#define INSTR_INFO(id, name, key, type, opcode, funct3, funct7, imm_type) \
+  [INSTR_##id] = {name, type, opcode, funct3, funct7, imm_type},
+    RV32_INSTRUCTIONS(INSTR_INFO)
+#undef INSTR_INFO
 };
 
 unsigned transform_beqz(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-
-
+  if (num_args != 2) {
+    return 0;
+  }
+  char* new_args[3] = {args[0], "x0", args[1]};
+  add_to_block(blk, "beq", new_args, 3);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -101,7 +59,12 @@ unsigned transform_beqz(Block* blk, char** args, int num_args) {
 unsigned transform_bnez(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
+  if (num_args != 2) {
+    return 0;
+  }
+  char* new_args[3] = {args[0], "x0", args[1]};
+  add_to_block(blk, "bne", new_args, 3);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -120,7 +83,41 @@ unsigned transform_bnez(Block* blk, char** args, int num_args) {
 unsigned transform_li(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
+  if (num_args != 2) {
+    return 0;
+  }
+  long int imm;
+  if (translate_num(&imm, args[1], IMM_NONE) != 0) {
+    return 0;
+  }
+  if (imm < INT32_MIN || imm > (long int)UINT32_MAX) {
+    return 0;
+  }
+
+  char imm_buf[16];
+  if (is_valid_imm(imm, IMM_12_SIGNED)) {
+    snprintf(imm_buf, sizeof(imm_buf), "%ld", imm);
+    char* addi_args[3] = {args[0], "x0", imm_buf};
+    add_to_block(blk, "addi", addi_args, 3);
+    return 1;
+  }
 
+  /* The lower 12 bits are sign-extended by addi, so round the upper part. */
+  uint32_t value = (uint32_t)imm;
+  uint32_t upper = ((value + 0x800) >> 12) & 0xFFFFF;
+  int32_t lower = (int32_t)(value & 0xFFF);
+  if (lower >= 0x800) {
+    lower -= 0x1000;
+  }
+
+  char upper_buf[16];
+  snprintf(upper_buf, sizeof(upper_buf), "%u", upper);
+  snprintf(imm_buf, sizeof(imm_buf), "%d", lower);
+  char* lui_args[2] = {args[0], upper_buf};
+  char* addi_args[3] = {args[0], args[0], imm_buf};
+  add_to_block(blk, "lui", lui_args, 2);
+  add_to_block(blk, "addi", addi_args, 3);
+  return 2;
   /* === end === */
   return 0;
 }
@@ -131,9 +128,12 @@ unsigned transform_li(Block* blk, char** args, int num_args) {
 unsigned transform_mv(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-  
-
+  if (num_args != 2) {
+    return 0;
+  }
+  char* new_args[3] = {args[0], args[1], "0"};
+  add_to_block(blk, "addi", new_args, 3);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -141,8 +141,12 @@ unsigned transform_mv(Block* blk, char** args, int num_args) {
 unsigned transform_j(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-
+  if (num_args != 1) {
+    return 0;
+  }
+  char* new_args[2] = {"x0", args[0]};
+  add_to_block(blk, "jal", new_args, 2);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -150,8 +154,12 @@ unsigned transform_j(Block* blk, char** args, int num_args) {
 unsigned transform_jr(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-
+  if (num_args != 1) {
+    return 0;
+  }
+  char* new_args[3] = {"x0", args[0], "0"};
+  add_to_block(blk, "jalr", new_args, 3);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -163,9 +171,16 @@ unsigned transform_jr(Block* blk, char** args, int num_args) {
 unsigned transform_jal(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-  
-
+  if (num_args == 2) {
+    add_to_block(blk, "jal", args, num_args);
+    return 1;
+  }
+  if (num_args != 1) {
+    return 0;
+  }
+  char* new_args[2] = {"ra", args[0]};
+  add_to_block(blk, "jal", new_args, 2);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -177,9 +192,16 @@ unsigned transform_jal(Block* blk, char** args, int num_args) {
 unsigned transform_jalr(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
-  
-
+  if (num_args == 3) {
+    add_to_block(blk, "jalr", args, num_args);
+    return 1;
+  }
+  if (num_args != 1) {
+    return 0;
+  }
+  char* new_args[3] = {"ra", args[0], "0"};
+  add_to_block(blk, "jalr", new_args, 3);
+  return 1;
   /* === end === */
   return 0;
 }
@@ -190,20 +212,46 @@ unsigned transform_jalr(Block* blk, char** args, int num_args) {
 unsigned transform_lw(Block* blk, char** args, int num_args) {
   /* IMPLEMENT ME */
   /* === start === */
-  
+  if (num_args == 3) {
+    add_to_block(blk, "lw", args, num_args);
+    return 1;
+  }
+  if (num_args != 2) {
+    return 0;
+  }
+  /* lw rd label => auipc rd label; lw rd label(rd) */
+  char* auipc_args[2] = {args[0], args[1]};
+  char* lw_args[3] = {args[0], args[1], args[0]};
+  add_to_block(blk, "auipc", auipc_args, 2);
+  add_to_block(blk, "lw", lw_args, 3);
+  return 2;
   /* === end === */
   return 0;
 }
 
-/* Traverse pseudo_handlers table to select corresponding handler by NAME */
+const char* pseudo_handler_name(PseudoId id) {
+  return pseudo_handlers[id].name;
+}
+
+uint64_t* count_pseudo_expansions(uint64_t* counts) {
+  uint64_t* previous = pseudo_counts;
+  pseudo_counts = counts;
+  return previous;
+}
+
+/* Select the handler for NAME with a single switch over the packed
+   mnemonic (see pack_token()), so no strcmp is needed. The cases are
+   generated from PSEUDO_INSTRUCTIONS. */
 const PseudoHandler* find_pseudo_handler(const char* name) {
-  for (size_t i = 0; i < sizeof(pseudo_handlers) / sizeof(pseudo_handlers[0]);
-       i++) {
-    if (strcmp(name, pseudo_handlers[i].name) == 0) {
-      return &pseudo_handlers[i];
-    }
+  switch (pack_token(name)) {
+#define PSEUDO_CASE(id, name, key, transform) \
+  case TOKEN_KEY key:                         \
+    return &pseudo_handlers[PSEUDO_##id];
+    PSEUDO_INSTRUCTIONS(PSEUDO_CASE)
+#undef PSEUDO_CASE
+    default:
+      return NULL;
   }
-  return NULL;
 }
 
 /* Writes instructions during the assembler's first pass to BLK. The case
@@ -228,14 +276,24 @@ unsigned write_pass_one(Block* blk, const char* name, char** args,
   /* Deal with pseudo-instructions */
   const PseudoHandler* handler = find_pseudo_handler(name);
   if (handler) {
-    return handler->transform(blk, args, num_args);
+    uint32_t first = blk->len;
+    unsigned written = handler->transform(blk, args, num_args);
+    /* The handlers pass the plain forms of jal, jalr and lw through
+       unchanged; only count the lines they actually rewrote. */
+    if (pseudo_counts && written > 0 &&
+        (written != 1 || blk->entries[first].arg_num != (uint32_t)num_args ||
+         strcmp(blk->entries[first].name, name) != 0)) {
+      pseudo_counts[handler - pseudo_handlers]++;
+    }
+    return written;
   }
   /* What about general instructions? */
   /* IMPLEMENT ME */
   /* === start === */
-
-
-  
+  if (add_to_block(blk, name, args, num_args) != 0) {
+    return 0;
+  }
+  return 1;
   /* === end === */
   return 0;
 }
@@ -260,72 +318,159 @@ unsigned write_pass_one(Block* blk, const char* name, char** args,
 
    Returns 0 on success and -1 on error.
  */
-int translate_inst(FILE* output, const char* name, char** args, size_t num_args,
-                   uint32_t addr, SymbolTable* symtbl) {
-  for (size_t i = 0; i < sizeof(instr_table) / sizeof(instr_table[0]); i++) {
-    const InstrInfo* info = &instr_table[i];
-    if (strcmp(name, info->name) == 0) {
-      switch (info->instr_type) {
-        case R_TYPE:
-          return write_rtype(output, info, args, num_args);
-        case I_TYPE:
-          return write_itype(output, info, args, num_args, addr, symtbl);
-        case S_TYPE:
-          return write_stype(output, info, args, num_args);
-        case SB_TYPE:
-          return write_sbtype(output, info, args, num_args, addr, symtbl);
-        case U_TYPE:
-          return write_utype(output, info, args, num_args, addr, symtbl);
-        case UJ_TYPE:
-          return write_ujtype(output, info, args, num_args, addr, symtbl);
-      }
-    }
+int translate_inst(OutputWriter* output, const char* name, char** args,
+                   size_t num_args, uint32_t addr, SymbolTable* symtbl) {
+  const InstrInfo* info = find_instr_info(name);
+  if (!info) {
+    return -1;
+  }
+  switch (info->instr_type) {
+    case R_TYPE:
+      return write_rtype(output, info, args, num_args);
+    case I_TYPE:
+      return write_itype(output, info, args, num_args, addr, symtbl);
+    case S_TYPE:
+      return write_stype(output, info, args, num_args);
+    case SB_TYPE:
+      return write_sbtype(output, info, args, num_args, addr, symtbl);
+    case U_TYPE:
+      return write_utype(output, info, args, num_args, addr, symtbl);
+    case UJ_TYPE:
+      return write_ujtype(output, info, args, num_args, addr, symtbl);
   }
   return -1;
 }
 
-/* A helper function for writing most R-type instructions. You should use
-   translate_reg() to parse registers and write_inst_hex() to write to
-   OUTPUT. Both are defined in translate_utils.h.
+/* Map NAME to its `instr_table` entry, or NULL if NAME is not a regular
+   instruction. Like find_pseudo_handler(), this is a single switch over the
+   packed mnemonic; the compiler lowers it to a jump table or binary search.
+   The cases are generated from RV32_INSTRUCTIONS, like the table. */
+const InstrInfo* find_instr_info(const char* name) {
+  switch (pack_token(name)) {
+#define INSTR_CASE(id, name, key, type, opcode, funct3, funct7, imm_type) \
+  case TOKEN_KEY key:                                                     \
+    return &instr_table[INSTR_##id];
+    RV32_INSTRUCTIONS(INSTR_CASE)
+#undef INSTR_CASE
+    default:
+      return NULL;
+  }
+}
 
-   This function is INCOMPLETE. Complete the implementation below. You will
-   find bitwise operations to be the cleanest way to complete this function.
- */
-int write_rtype(FILE* output, const InstrInfo* info, char** args,
-                size_t num_args) {
-  /* IMPLEMENT ME */
-  /* === start === */
-  
-  
+/* The `instr_table` entry of ID. */
+const InstrInfo* instr_info(InstrId id) { return &instr_table[id]; }
 
-  /* === end === */
+/*******************************
+ * Decoding and Encoding
+ *******************************/
+
+/* Parses the register name STR into *OUT. Returns -1 if it is invalid. */
+static int decode_reg(uint8_t* out, const char* str) {
+  int reg = translate_reg(str);
+  if (reg == -1) {
+    return -1;
+  }
+  *out = (uint8_t)reg;
   return 0;
 }
 
-/* Hint:
-  - Number of ARGS and immediate range of each I_type instruction may
-  vary. Refer to RISC-V green card and design proper encoding rules.
-  - Some instruction(s) expanded from pseudo ones may has(have) unresolved
-  label(s). You need to take that special case into consideration. Refer to
-  write_sbtype for detailed relative address calculation.
+/* Parses STR as an immediate of TYPE into IR->imm. If that fails and
+   ALLOW_LABEL is set, STR is accepted as a label instead and returned
+   through LABEL; its value is only known once the symbol table is complete.
  */
-int write_itype(FILE* output, const InstrInfo* info, char** args,
-                size_t num_args, uint32_t addr, SymbolTable* symtbl) {
-  /* IMPLEMENT ME */
-  /* === start === */
-  
-  /* === end === */
+static int decode_operand(IrInstr* ir, const char** label, const char* str,
+                          ImmType type, int allow_label) {
+  long int imm;
+  if (translate_num(&imm, str, type) == 0) {
+    ir->imm = (int32_t)imm;
+    return 0;
+  }
+  if (!allow_label || !is_valid_label(str)) {
+    return -1;
+  }
+  ir->sym = 0;
+  *label = str;
   return 0;
 }
 
-int write_stype(FILE* output, const InstrInfo* info, char** args,
-                size_t num_args) {
-  /* IMPLEMENT ME */
-  /* === start === */
-  
+/* Checks the operands of one instruction with format INFO and fills IR.
+   This performs every check that does not depend on the symbol table. */
+static int decode_args(IrInstr* ir, const char** label, const InstrInfo* info,
+                       char** args, size_t num_args) {
+  ir->op = (uint8_t)(info - instr_table);
+  ir->rd = 0;
+  ir->rs1 = 0;
+  ir->rs2 = 0;
+  ir->imm = 0;
+  ir->sym = IR_NO_SYMBOL;
+  *label = NULL;
+
+  switch (info->instr_type) {
+    case R_TYPE:
+      if (num_args != 3 || decode_reg(&ir->rd, args[0]) != 0 ||
+          decode_reg(&ir->rs1, args[1]) != 0 ||
+          decode_reg(&ir->rs2, args[2]) != 0) {
+        return -1;
+      }
+      return 0;
+    case I_TYPE:
+      /* ecall takes no operands at all. */
+      if (info->imm_type == IMM_NONE) {
+        return num_args == 0 ? 0 : -1;
+      }
+      if (num_args != 3 || decode_reg(&ir->rd, args[0]) != 0) {
+        return -1;
+      }
+      /* Loads are written as `rd offset(rs1)`, everything else as
+         `rd rs1 imm`. Only loads and jalr may name a label (from `lw rd
+         label` and from a relaxed jal, see relax.h); the offset is then
+         relative to the auipc before them. */
+      if (info->opcode == 0x03) {
+        if (decode_reg(&ir->rs1, args[2]) != 0) {
+          return -1;
+        }
+        return decode_operand(ir, label, args[1], info->imm_type, 1);
+      }
+      if (decode_reg(&ir->rs1, args[1]) != 0) {
+        return -1;
+      }
+      return decode_operand(ir, label, args[2], info->imm_type,
+                            ir->op == INSTR_JALR);
+    case S_TYPE:
+      if (num_args != 3 || decode_reg(&ir->rs2, args[0]) != 0 ||
+          decode_reg(&ir->rs1, args[2]) != 0) {
+        return -1;
+      }
+      return decode_operand(ir, label, args[1], info->imm_type, 0);
+    case SB_TYPE:
+      if (num_args != 3 || decode_reg(&ir->rs1, args[0]) != 0 ||
+          decode_reg(&ir->rs2, args[1]) != 0) {
+        return -1;
+      }
+      return decode_operand(ir, label, args[2], info->imm_type, 1);
+    case U_TYPE:
+      if (num_args != 2 || decode_reg(&ir->rd, args[0]) != 0) {
+        return -1;
+      }
+      /* Only auipc may carry a label (from the `lw rd label` expansion). */
+      return decode_operand(ir, label, args[1], info->imm_type,
+                            info->opcode == 0x17);
+    case UJ_TYPE:
+      if (num_args != 2 || decode_reg(&ir->rd, args[0]) != 0) {
+        return -1;
+      }
+      return decode_operand(ir, label, args[1], info->imm_type, 1);
+  }
+  return -1;
+}
 
-  /* === end === */
-  return 0;
+int decode_inst(IrInstr* ir, const char** label, const char* name,
+                char** args, size_t num_args) {
+  const InstrInfo* info = find_instr_info(name);
+  if (!info) {
+    return -1;
+  }
+  return decode_args(ir, label, info, args, num_args);
 }
 
 /* Hint:
@@ -338,41 +483,140 @@ int write_stype(FILE* output, const InstrInfo* info, char** args,
    so the relative addres is
      I = L - A
 */
-int write_sbtype(FILE* output, const InstrInfo* info, char** args,
-                 size_t num_args, uint32_t addr, SymbolTable* symtbl) {
-  /* IMPLEMENT ME */
-  /* === start === */
-  
-  
+int encode_inst(const IrInstr* ir, uint32_t addr, int64_t label_addr,
+                uint32_t* word) {
+  const InstrInfo* info = &instr_table[ir->op];
+  int has_label = ir->sym != IR_NO_SYMBOL;
+  if (has_label && label_addr == -1) {
+    return -1;
+  }
+  uint32_t rd = ir->rd;
+  uint32_t rs1 = ir->rs1;
+  uint32_t rs2 = ir->rs2;
+  uint32_t funct3 = info->funct3;
+  uint32_t opcode = info->opcode;
+  int64_t imm = ir->imm;
+  uint32_t uimm;
+
+  switch (info->instr_type) {
+    case R_TYPE:
+      *word = ((uint32_t)info->funct7 << 25) | (rs2 << 20) | (rs1 << 15) |
+              (funct3 << 12) | (rd << 7) | opcode;
+      return 0;
+    case I_TYPE:
+      if (info->imm_type == IMM_NONE) {
+        *word = opcode;
+        return 0;
+      }
+      if (has_label) {
+        /* `lw rd label` expands to auipc+lw (and a far jal to auipc+jalr);
+           the offset is relative to the preceding auipc and only the
+           sign-extended low 12 bits are kept. */
+        uint32_t offset = (uint32_t)(label_addr - (int64_t)(addr - 4));
+        imm = offset & 0xFFF;
+      }
+      /* funct7 holds the upper immediate bits of srai. */
+      uimm = ((uint32_t)imm & 0xFFF) | ((uint32_t)info->funct7 << 5);
+      *word = (uimm << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+      return 0;
+    case S_TYPE:
+      uimm = (uint32_t)imm;
+      *word = (((uimm >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) |
+              (funct3 << 12) | ((uimm & 0x1F) << 7) | opcode;
+      return 0;
+    case SB_TYPE:
+      if (has_label) {
+        imm = label_addr - (int64_t)addr;
+        if (!is_valid_imm((long)imm, info->imm_type)) {
+          return -1;
+        }
+      }
+      uimm = (uint32_t)imm;
+      *word = (((uimm >> 12) & 0x1) << 31) | (((uimm >> 5) & 0x3F) << 25) |
+              (rs2 << 20) | (rs1 << 15) | (funct3 << 12) |
+              (((uimm >> 1) & 0xF) << 8) | (((uimm >> 11) & 0x1) << 7) |
+              opcode;
+      return 0;
+    case U_TYPE:
+      if (has_label) {
+        /* The upper part is rounded so that the following lw can add a
+           signed low part. */
+        uint32_t offset = (uint32_t)(label_addr - (int64_t)addr);
+        imm = ((offset + 0x800) >> 12) & 0xFFFFF;
+      }
+      *word = ((uint32_t)imm << 12) | (rd << 7) | opcode;
+      return 0;
+    case UJ_TYPE:
+      if (has_label) {
+        imm = label_addr - (int64_t)addr;
+        if (!is_valid_imm((long)imm, info->imm_type)) {
+          return -1;
+        }
+      }
+      uimm = (uint32_t)imm;
+      *word = (((uimm >> 20) & 0x1) << 31) | (((uimm >> 1) & 0x3FF) << 21) |
+              (((uimm >> 11) & 0x1) << 20) | (((uimm >> 12) & 0xFF) << 12) |
+              (rd << 7) | opcode;
+      return 0;
+  }
+  return -1;
+}
 
-  /* === end === */
+/* Decodes one instruction of format INFO, resolves its label (if any) in
+   SYMTBL and writes the encoding to OUTPUT. */
+static int write_decoded(OutputWriter* output, const InstrInfo* info,
+                         char** args, size_t num_args, uint32_t addr,
+                         SymbolTable* symtbl) {
+  IrInstr ir;
+  const char* label;
+  uint32_t instruction;
+
+  if (decode_args(&ir, &label, info, args, num_args) != 0) {
+    return -1;
+  }
+  int64_t label_addr = label ? get_addr_for_symbol(symtbl, label) : 0;
+  if (encode_inst(&ir, addr, label_addr, &instruction) != 0) {
+    return -1;
+  }
+  write_inst(output, instruction);
   return 0;
 }
 
-/* Hint:
-  - Some instruction(s) expanded from pseudo ones may has(have) unresolved
-  label(s). You need to take that special case into consideration. Refer to
-  write_sbtype for detailed relative address calculation.
- */
-int write_utype(FILE* output, const InstrInfo* info, char** args,
+/* The write_*type() functions below translate a single instruction of the
+   given format straight from its strings. They share decode_args() and
+   encode_inst() with the pre-decoded path used by pass two (see ir.h), so
+   both accept exactly the same inputs. */
+
+int write_rtype(OutputWriter* output, const InstrInfo* info, char** args,
+                size_t num_args) {
+  return write_decoded(output, info, args, num_args, 0, NULL);
+}
+
+/* Some instruction(s) expanded from pseudo ones may have unresolved labels:
+   `lw rd label` resolves relative to the preceding auipc. */
+int write_itype(OutputWriter* output, const InstrInfo* info, char** args,
                 size_t num_args, uint32_t addr, SymbolTable* symtbl) {
-  /* IMPLEMENT ME */
-  /* === start === */
-  
-  
+  return write_decoded(output, info, args, num_args, addr, symtbl);
+}
 
-  /* === end === */
-  return 0;
+int write_stype(OutputWriter* output, const InstrInfo* info, char** args,
+                size_t num_args) {
+  return write_decoded(output, info, args, num_args, 0, NULL);
+}
+
+int write_sbtype(OutputWriter* output, const InstrInfo* info, char** args,
+                 size_t num_args, uint32_t addr, SymbolTable* symtbl) {
+  return write_decoded(output, info, args, num_args, addr, symtbl);
+}
+
+int write_utype(OutputWriter* output, const InstrInfo* info, char** args,
+                size_t num_args, uint32_t addr, SymbolTable* symtbl) {
+  return write_decoded(output, info, args, num_args, addr, symtbl);
 }
 
 /* In this project there is no need to relocate labels,
    you may think about the reasons. */
-int write_ujtype(FILE* output, const InstrInfo* info, char** args,
+int write_ujtype(OutputWriter* output, const InstrInfo* info, char** args,
                  size_t num_args, uint32_t addr, SymbolTable* symtbl) {
-  /* IMPLEMENT ME */
-  /* === start === */
-  
-  /* === end === */
-  return 0;
+  return write_decoded(output, info, args, num_args, addr, symtbl);
 }
-
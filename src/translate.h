@@ -12,12 +12,36 @@
 #include "block.h"
 #include "tables.h"
 #include "translate_utils.h"
+#include "writer.h"
 
 typedef struct {
   const char* name;
   unsigned (*transform)(Block*, char**, int);
 } PseudoHandler;
 
+/* Every pseudo-instruction, as X(ID, NAME, KEY, TRANSFORM) with KEY the
+   characters of NAME padded to five with 0, in parentheses (the arguments
+   of TOKEN_KEY()). PseudoId, the handler table and find_pseudo_handler()
+   are all generated from this list. */
+#define PSEUDO_INSTRUCTIONS(X)                                               \
+  X(BEQZ, "beqz", ('b', 'e', 'q', 'z', 0), transform_beqz)                   \
+  X(BNEZ, "bnez", ('b', 'n', 'e', 'z', 0), transform_bnez)                   \
+  X(LI, "li", ('l', 'i', 0, 0, 0), transform_li)                             \
+  X(MV, "mv", ('m', 'v', 0, 0, 0), transform_mv)                             \
+  X(J, "j", ('j', 0, 0, 0, 0), transform_j)                                  \
+  X(JR, "jr", ('j', 'r', 0, 0, 0), transform_jr)                             \
+  X(JAL, "jal", ('j', 'a', 'l', 0, 0), transform_jal)                        \
+  X(JALR, "jalr", ('j', 'a', 'l', 'r', 0), transform_jalr)                   \
+  X(LW, "lw", ('l', 'w', 0, 0, 0), transform_lw)
+
+/* Indices into the pseudo-instruction handler table. */
+typedef enum {
+#define PSEUDO_ID(id, name, key, transform) PSEUDO_##id,
+  PSEUDO_INSTRUCTIONS(PSEUDO_ID)
+#undef PSEUDO_ID
+  NUM_PSEUDOS,
+} PseudoId;
+
 /* IMPLEMENT ME - see documentation in translate.c */
 unsigned transform_beqz(Block* blk, char** args, int num_args);
 
@@ -47,6 +71,14 @@ unsigned transform_lw(Block* blk, char** args, int num_args);
 
 const PseudoHandler* find_pseudo_handler(const char* name);
 
+/* Mnemonic of the pseudo-instruction ID. */
+const char* pseudo_handler_name(PseudoId id);
+
+/* While COUNTS (NUM_PSEUDOS entries, indexed by PseudoId) is set,
+   write_pass_one() on the calling thread adds one to a handler's entry for
+   every line it expands. NULL stops counting. Returns the previous array. */
+uint64_t* count_pseudo_expansions(uint64_t* counts);
+
 unsigned write_pass_one(Block* blk, const char* name, char** args,
                         int num_args);
 
@@ -62,31 +94,173 @@ typedef struct {
   ImmType imm_type; /* imm type (see translate_utils.h) */
 } InstrInfo;
 
+/* Every regular instruction, as X(ID, NAME, KEY, TYPE, OPCODE, FUNCT3,
+   FUNCT7, IMM_TYPE) with the fields of InstrInfo and KEY as in
+   PSEUDO_INSTRUCTIONS. InstrId, `instr_table` and find_instr_info() are all
+   generated from this list, so an instruction is added in one place. */
+#define RV32_INSTRUCTIONS(X)                                                 \
+  /* R-type instructions */                                                  \
+  X(ADD, "add", ('a', 'd', 'd', 0, 0),                                       \
+    R_TYPE, 0x33, 0x0, 0x00, IMM_NONE)                                       \
+  X(SUB, "sub", ('s', 'u', 'b', 0, 0),                                       \
+    R_TYPE, 0x33, 0x0, 0x20, IMM_NONE)                                       \
+  X(XOR, "xor", ('x', 'o', 'r', 0, 0),                                       \
+    R_TYPE, 0x33, 0x4, 0x00, IMM_NONE)                                       \
+  X(OR, "or", ('o', 'r', 0, 0, 0),                                           \
+    R_TYPE, 0x33, 0x6, 0x00, IMM_NONE)                                       \
+  X(AND, "and", ('a', 'n', 'd', 0, 0),                                       \
+    R_TYPE, 0x33, 0x7, 0x00, IMM_NONE)                                       \
+  X(SLL, "sll", ('s', 'l', 'l', 0, 0),                                       \
+    R_TYPE, 0x33, 0x1, 0x00, IMM_NONE)                                       \
+  X(SRL, "srl", ('s', 'r', 'l', 0, 0),                                       \
+    R_TYPE, 0x33, 0x5, 0x00, IMM_NONE)                                       \
+  X(SRA, "sra", ('s', 'r', 'a', 0, 0),                                       \
+    R_TYPE, 0x33, 0x5, 0x20, IMM_NONE)                                       \
+  X(SLT, "slt", ('s', 'l', 't', 0, 0),                                       \
+    R_TYPE, 0x33, 0x2, 0x00, IMM_NONE)                                       \
+  X(SLTU, "sltu", ('s', 'l', 't', 'u', 0),                                   \
+    R_TYPE, 0x33, 0x3, 0x00, IMM_NONE)                                       \
+  X(MUL, "mul", ('m', 'u', 'l', 0, 0),                                       \
+    R_TYPE, 0x33, 0x0, 0x01, IMM_NONE)                                       \
+  X(MULH, "mulh", ('m', 'u', 'l', 'h', 0),                                   \
+    R_TYPE, 0x33, 0x1, 0x01, IMM_NONE)                                       \
+  X(DIV, "div", ('d', 'i', 'v', 0, 0),                                       \
+    R_TYPE, 0x33, 0x4, 0x01, IMM_NONE)                                       \
+  X(REM, "rem", ('r', 'e', 'm', 0, 0),                                       \
+    R_TYPE, 0x33, 0x6, 0x01, IMM_NONE)                                       \
+  /* I-type instructions */                                                  \
+  X(ADDI, "addi", ('a', 'd', 'd', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x0, 0x00, IMM_12_SIGNED)                                  \
+  X(XORI, "xori", ('x', 'o', 'r', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x4, 0x00, IMM_12_SIGNED)                                  \
+  X(ORI, "ori", ('o', 'r', 'i', 0, 0),                                       \
+    I_TYPE, 0x13, 0x6, 0x00, IMM_12_SIGNED)                                  \
+  X(ANDI, "andi", ('a', 'n', 'd', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x7, 0x00, IMM_12_SIGNED)                                  \
+  X(SLLI, "slli", ('s', 'l', 'l', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x1, 0x00, IMM_5_UNSIGNED)                                 \
+  X(SRLI, "srli", ('s', 'r', 'l', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x5, 0x00, IMM_5_UNSIGNED)                                 \
+  X(SRAI, "srai", ('s', 'r', 'a', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x5, 0x20, IMM_5_UNSIGNED)                                 \
+  X(SLTI, "slti", ('s', 'l', 't', 'i', 0),                                   \
+    I_TYPE, 0x13, 0x2, 0x00, IMM_12_SIGNED)                                  \
+  X(SLTIU, "sltiu", ('s', 'l', 't', 'i', 'u'),                               \
+    I_TYPE, 0x13, 0x3, 0x00, IMM_12_SIGNED)                                  \
+  X(LB, "lb", ('l', 'b', 0, 0, 0),                                           \
+    I_TYPE, 0x03, 0x0, 0x00, IMM_12_SIGNED)                                  \
+  X(LH, "lh", ('l', 'h', 0, 0, 0),                                           \
+    I_TYPE, 0x03, 0x1, 0x00, IMM_12_SIGNED)                                  \
+  X(LW, "lw", ('l', 'w', 0, 0, 0),                                           \
+    I_TYPE, 0x03, 0x2, 0x00, IMM_12_SIGNED)                                  \
+  X(LBU, "lbu", ('l', 'b', 'u', 0, 0),                                       \
+    I_TYPE, 0x03, 0x4, 0x00, IMM_12_SIGNED)                                  \
+  X(LHU, "lhu", ('l', 'h', 'u', 0, 0),                                       \
+    I_TYPE, 0x03, 0x5, 0x00, IMM_12_SIGNED)                                  \
+  X(JALR, "jalr", ('j', 'a', 'l', 'r', 0),                                   \
+    I_TYPE, 0x67, 0x0, 0x00, IMM_12_SIGNED)                                  \
+  X(ECALL, "ecall", ('e', 'c', 'a', 'l', 'l'),                               \
+    I_TYPE, 0x73, 0x0, 0x00, IMM_NONE)                                       \
+  /* S-type instructions */                                                  \
+  X(SB, "sb", ('s', 'b', 0, 0, 0),                                           \
+    S_TYPE, 0x23, 0x0, 0x00, IMM_12_SIGNED)                                  \
+  X(SH, "sh", ('s', 'h', 0, 0, 0),                                           \
+    S_TYPE, 0x23, 0x1, 0x00, IMM_12_SIGNED)                                  \
+  X(SW, "sw", ('s', 'w', 0, 0, 0),                                           \
+    S_TYPE, 0x23, 0x2, 0x00, IMM_12_SIGNED)                                  \
+  /* SB-type instructions */                                                 \
+  X(BEQ, "beq", ('b', 'e', 'q', 0, 0),                                       \
+    SB_TYPE, 0x63, 0x0, 0x00, IMM_13_SIGNED)                                 \
+  X(BNE, "bne", ('b', 'n', 'e', 0, 0),                                       \
+    SB_TYPE, 0x63, 0x1, 0x00, IMM_13_SIGNED)                                 \
+  X(BLT, "blt", ('b', 'l', 't', 0, 0),                                       \
+    SB_TYPE, 0x63, 0x4, 0x00, IMM_13_SIGNED)                                 \
+  X(BGE, "bge", ('b', 'g', 'e', 0, 0),                                       \
+    SB_TYPE, 0x63, 0x5, 0x00, IMM_13_SIGNED)                                 \
+  X(BLTU, "bltu", ('b', 'l', 't', 'u', 0),                                   \
+    SB_TYPE, 0x63, 0x6, 0x00, IMM_13_SIGNED)                                 \
+  X(BGEU, "bgeu", ('b', 'g', 'e', 'u', 0),                                   \
+    SB_TYPE, 0x63, 0x7, 0x00, IMM_13_SIGNED)                                 \
+  /* U-type instructions */                                                  \
+  X(LUI, "lui", ('l', 'u', 'i', 0, 0),                                       \
+    U_TYPE, 0x37, 0x0, 0x00, IMM_20_UNSIGNED)                                \
+  X(AUIPC, "auipc", ('a', 'u', 'i', 'p', 'c'),                               \
+    U_TYPE, 0x17, 0x0, 0x00, IMM_20_UNSIGNED)                                \
+  /* UJ-type instructions */                                                 \
+  X(JAL, "jal", ('j', 'a', 'l', 0, 0),                                       \
+    UJ_TYPE, 0x6f, 0x0, 0x00, IMM_21_SIGNED)
+
+/* Indices into the instruction table, one per supported mnemonic. */
+typedef enum {
+#define INSTR_ID(id, name, key, type, opcode, funct3, funct7, imm_type) \
+  INSTR_##id,
+  RV32_INSTRUCTIONS(INSTR_ID)
+#undef INSTR_ID
+  NUM_INSTRS,
+} InstrId;
+
+const InstrInfo* find_instr_info(const char* name);
+
+/* The `instr_table` entry of ID, which must be below NUM_INSTRS. */
+const InstrInfo* instr_info(InstrId id);
+
+/* Marks an IrInstr without a label operand. */
+#define IR_NO_SYMBOL UINT32_MAX
+
+/* Marks an IrInstr whose source text did not decode. */
+#define IR_INVALID 0xFF
+
+/* A pre-decoded instruction: everything pass two needs to encode it apart
+   from the address of a referenced label. */
+typedef struct {
+  uint8_t op;   /* InstrId, or IR_INVALID */
+  uint8_t rd;
+  uint8_t rs1;
+  uint8_t rs2;
+  int32_t imm;  /* immediate; unused if the instruction names a label */
+  uint32_t sym; /* label reference id, or IR_NO_SYMBOL */
+} IrInstr;
+
+/* Checks and parses the instruction NAME ARGS into IR. If an operand is a
+   label, it is returned through LABEL (otherwise LABEL is set to NULL) and
+   IR->sym is set to 0; the caller may replace it with its own reference id.
+   Returns 0 on success and -1 if the instruction is invalid.
+ */
+int decode_inst(IrInstr* ir, const char** label, const char* name,
+                char** args, size_t num_args);
+
+/* Encodes IR at byte offset ADDR into *WORD. LABEL_ADDR is the address of
+   the referenced label, or -1 if it is undefined; it is ignored when IR has
+   no label. Returns -1 if the label is undefined or out of range.
+ */
+int encode_inst(const IrInstr* ir, uint32_t addr, int64_t label_addr,
+                uint32_t* word);
+
 /* IMPLEMENT ME - see documentation in translate.c */
-int write_rtype(FILE* output, const InstrInfo* info, char** args,
+int write_rtype(OutputWriter* output, const InstrInfo* info, char** args,
                 size_t num_args);
 
 /* IMPLEMENT ME - see documentation in translate.c */
-int write_itype(FILE* output, const InstrInfo* info, char** args,
+int write_itype(OutputWriter* output, const InstrInfo* info, char** args,
                 size_t num_args, uint32_t addr, SymbolTable* symtbl);
 
 /* IMPLEMENT ME - see documentation in translate.c */
-int write_stype(FILE* output, const InstrInfo* info, char** args,
+int write_stype(OutputWriter* output, const InstrInfo* info, char** args,
                 size_t num_args);
 
 /* IMPLEMENT ME - see documentation in translate.c */
-int write_sbtype(FILE* output, const InstrInfo* info, char** args,
+int write_sbtype(OutputWriter* output, const InstrInfo* info, char** args,
                  size_t num_args, uint32_t addr, SymbolTable* symtbl);
 
 /* IMPLEMENT ME - see documentation in translate.c */
-int write_utype(FILE* output, const InstrInfo* info, char** args,
+int write_utype(OutputWriter* output, const InstrInfo* info, char** args,
                 size_t num_args, uint32_t addr, SymbolTable* symtbl);
 
 /* IMPLEMENT ME - see documentation in translate.c */
-int write_ujtype(FILE* output, const InstrInfo* info, char** args,
+int write_ujtype(OutputWriter* output, const InstrInfo* info, char** args,
                  size_t num_args, uint32_t addr, SymbolTable* symtbl);
 
 /* IMPLEMENT ME - see documentation in translate.c */
-int translate_inst(FILE* output, const char* name, char** args, size_t num_args,
-                   uint32_t addr, SymbolTable* symtbl);
+int translate_inst(OutputWriter* output, const char* name, char** args,
+                   size_t num_args, uint32_t addr, SymbolTable* symtbl);
 #endif
@@ -23,8 +23,25 @@ void write_inst_string(FILE* output, const char* name, char** args,
   fprintf(output, "\n");
 }
 
-void write_inst_hex(FILE* output, uint32_t instruction) {
-  fprintf(output, "0x%08X\n", instruction);
+void write_inst_hex(OutputWriter* output, uint32_t instruction) {
+  writer_put_hex(output, instruction);
+}
+
+void write_inst(OutputWriter* output, uint32_t instruction) {
+  writer_put_word(output, instruction);
+}
+
+uint64_t pack_token(const char* str) {
+  uint64_t key = 0;
+  int i;
+
+  for (i = 0; str[i]; i++) {
+    if (i == MAX_PACKED_TOKEN_LEN) {
+      return 0;
+    }
+    key |= (uint64_t)(unsigned char)str[i] << (8 * i);
+  }
+  return key;
 }
 
 int is_valid_label(const char* str) {
@@ -87,45 +104,112 @@ int translate_num(long int* output, const char* str, ImmType type) {
   return 0;
 }
 
-typedef struct {
-  const char* name;
-  uint8_t number;
-} RegEntry;
-
-static const RegEntry reg_map[] = {
-    {"zero", 0}, {"ra", 1},   {"sp", 2},   {"gp", 3},   {"tp", 4},
-    {"t0", 5},   {"t1", 6},   {"t2", 7},   {"s0", 8},   {"fp", 8},
-    {"s1", 9},   {"a0", 10},  {"a1", 11},  {"a2", 12},  {"a3", 13},
-    {"a4", 14},  {"a5", 15},  {"a6", 16},  {"a7", 17},  {"s2", 18},
-    {"s3", 19},  {"s4", 20},  {"s5", 21},  {"s6", 22},  {"s7", 23},
-    {"s8", 24},  {"s9", 25},  {"s10", 26}, {"s11", 27}, {"t3", 28},
-    {"t4", 29},  {"t5", 30},  {"t6", 31},  {"x0", 0},   {"x1", 1},
-    {"x2", 2},   {"x3", 3},   {"x4", 4},   {"x5", 5},   {"x6", 6},
-    {"x7", 7},   {"x8", 8},   {"x9", 9},   {"x10", 10}, {"x11", 11},
-    {"x12", 12}, {"x13", 13}, {"x14", 14}, {"x15", 15}, {"x16", 16},
-    {"x17", 17}, {"x18", 18}, {"x19", 19}, {"x20", 20}, {"x21", 21},
-    {"x22", 22}, {"x23", 23}, {"x24", 24}, {"x25", 25}, {"x26", 26},
-    {"x27", 27}, {"x28", 28}, {"x29", 29}, {"x30", 30}, {"x31", 31}};
+/* Translates `xN` register names. N must be 0-31 written without leading
+   zeros, so "x05" and "x32" are rejected. Returns -1 if STR is not of this
+   form.
+ */
+static int translate_numeric_reg(const char* str) {
+  if (str[0] != 'x' || !isdigit((unsigned char)str[1])) {
+    return -1;
+  }
+  if (str[2] == '\0') {
+    return str[1] - '0';
+  }
+  if (str[1] == '0' || !isdigit((unsigned char)str[2]) || str[3] != '\0') {
+    return -1;
+  }
+  int number = (str[1] - '0') * 10 + (str[2] - '0');
+  return number < 32 ? number : -1;
+}
 
 /* Translates the register name to the corresponding register number. Please
    see the RISC-V Green Sheet for information about register numbers.
-   You may use the `reg_map` above to translate registers.
+
+   `xN` names are decoded arithmetically; ABI names are matched with a single
+   switch over the packed name (see pack_token()), so no table is scanned.
 
    Returns the register number of STR or -1 if the register name is invalid.
  */
 int translate_reg(const char* str) {
   /* IMPLEMENT ME */
   /* === start === */
+  if (!str) {
+    return -1;
+  }
+  if (str[0] == 'x') {
+    return translate_numeric_reg(str);
+  }
 
-  const size_t reg_map_size = sizeof(reg_map) / sizeof(RegEntry);
-    
-  // 遍历寄存器映射表
-  for (size_t i = 0; i < reg_map_size; i++) {
-      if (strcmp(str, reg_map[i].name) == 0) {
-          return reg_map[i].number;
-      }
+  switch (pack_token(str)) {
+    case TOKEN_KEY('z', 'e', 'r', 'o', 0):
+      return 0;
+    case TOKEN_KEY('r', 'a', 0, 0, 0):
+      return 1;
+    case TOKEN_KEY('s', 'p', 0, 0, 0):
+      return 2;
+    case TOKEN_KEY('g', 'p', 0, 0, 0):
+      return 3;
+    case TOKEN_KEY('t', 'p', 0, 0, 0):
+      return 4;
+    case TOKEN_KEY('t', '0', 0, 0, 0):
+      return 5;
+    case TOKEN_KEY('t', '1', 0, 0, 0):
+      return 6;
+    case TOKEN_KEY('t', '2', 0, 0, 0):
+      return 7;
+    case TOKEN_KEY('s', '0', 0, 0, 0):
+      return 8;
+    case TOKEN_KEY('f', 'p', 0, 0, 0):
+      return 8;
+    case TOKEN_KEY('s', '1', 0, 0, 0):
+      return 9;
+    case TOKEN_KEY('a', '0', 0, 0, 0):
+      return 10;
+    case TOKEN_KEY('a', '1', 0, 0, 0):
+      return 11;
+    case TOKEN_KEY('a', '2', 0, 0, 0):
+      return 12;
+    case TOKEN_KEY('a', '3', 0, 0, 0):
+      return 13;
+    case TOKEN_KEY('a', '4', 0, 0, 0):
+      return 14;
+    case TOKEN_KEY('a', '5', 0, 0, 0):
+      return 15;
+    case TOKEN_KEY('a', '6', 0, 0, 0):
+      return 16;
+    case TOKEN_KEY('a', '7', 0, 0, 0):
+      return 17;
+    case TOKEN_KEY('s', '2', 0, 0, 0):
+      return 18;
+    case TOKEN_KEY('s', '3', 0, 0, 0):
+      return 19;
+    case TOKEN_KEY('s', '4', 0, 0, 0):
+      return 20;
+    case TOKEN_KEY('s', '5', 0, 0, 0):
+      return 21;
+    case TOKEN_KEY('s', '6', 0, 0, 0):
+      return 22;
+    case TOKEN_KEY('s', '7', 0, 0, 0):
+      return 23;
+    case TOKEN_KEY('s', '8', 0, 0, 0):
+      return 24;
+    case TOKEN_KEY('s', '9', 0, 0, 0):
+      return 25;
+    case TOKEN_KEY('s', '1', '0', 0, 0):
+      return 26;
+    case TOKEN_KEY('s', '1', '1', 0, 0):
+      return 27;
+    case TOKEN_KEY('t', '3', 0, 0, 0):
+      return 28;
+    case TOKEN_KEY('t', '4', 0, 0, 0):
+      return 29;
+    case TOKEN_KEY('t', '5', 0, 0, 0):
+      return 30;
+    case TOKEN_KEY('t', '6', 0, 0, 0):
+      return 31;
+    default:
+      return -1;
   }
-  return -1;  // 未找到返回-1
 
   /* === end === */
 }
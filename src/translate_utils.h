@@ -5,6 +5,8 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "writer.h"
+
 typedef enum {
   IMM_NONE,      /* No immediate value */
   IMM_12_SIGNED, /* 12-bit signed number */
@@ -21,6 +23,22 @@ typedef enum {
   /* === end === */
 } ImmType;
 
+/* Longest token accepted by pack_token(). */
+#define MAX_PACKED_TOKEN_LEN 8
+
+/* Integer key of a token of up to five characters; pad with 0. The result
+   equals pack_token() of the same string, so it can be used as a case label
+   when switching over mnemonics or register names. */
+#define TOKEN_KEY(a, b, c, d, e)                                             \
+  ((uint64_t)(unsigned char)(a) | (uint64_t)(unsigned char)(b) << 8 |        \
+   (uint64_t)(unsigned char)(c) << 16 |                                      \
+   (uint64_t)(unsigned char)(d) << 24 | (uint64_t)(unsigned char)(e) << 32)
+
+/* Packs STR into an integer, one byte per character, so that a fixed set of
+   short names can be matched with a switch instead of repeated strcmp calls.
+   Returns 0 if STR is empty or longer than MAX_PACKED_TOKEN_LEN. */
+uint64_t pack_token(const char* str);
+
 /* Writes the instruction as a string to OUTPUT. NAME is the name of the
    instruction, and its arguments are in ARGS. NUM_ARGS is the length of
    the array.
@@ -29,7 +47,10 @@ void write_inst_string(FILE* output, const char* name, char** args,
                        int num_args);
 
 /* Writes the instruction to OUTPUT in hexadecimal format. */
-void write_inst_hex(FILE* output, uint32_t instruction);
+void write_inst_hex(OutputWriter* output, uint32_t instruction);
+
+/* Writes the instruction to OUTPUT in the writer's word format. */
+void write_inst(OutputWriter* output, uint32_t instruction);
 
 /* Returns 1 if the label is valid and 0 if it is invalid. A valid label is one
    where the first character is a character or underscore and the remaining
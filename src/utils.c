@@ -6,17 +6,107 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
+#include "utils.h"
+
 /*******************************
  * Do Not Modify Code Below
  *******************************/
 
-static const char* output_file = NULL;
+/* The logger state is per thread, so that several assemble() calls can run
+   at the same time on different threads, each with its own log file. */
+static _Thread_local const char* output_file = NULL;
+
+/* Stream for OUTPUT_FILE. It is opened on the first message and stays open
+   until close_log(), so a run with many diagnostics does not pay for an
+   fopen()/fclose() pair per message. */
+static _Thread_local FILE* log_stream = NULL;
+static _Thread_local char* log_buffer = NULL;
+
+/* In-memory destination set with set_log_writer(); takes precedence over
+   OUTPUT_FILE. */
+static _Thread_local OutputWriter* log_writer = NULL;
+
+/* Where the allocation failure handlers jump to, or NULL to exit. */
+static _Thread_local jmp_buf* allocation_recovery = NULL;
+
+/* Returns the open log stream, opening it if necessary, or NULL. */
+static FILE* open_log(void) {
+  if (!log_stream) {
+    log_stream = fopen(output_file, "a");
+    if (log_stream) {
+      /* Without a buffer of our own stdio would use a small default one. */
+      log_buffer = malloc(LOG_BUFFER_SIZE);
+      if (log_buffer) {
+        setvbuf(log_stream, log_buffer, _IOFBF, LOG_BUFFER_SIZE);
+      }
+    }
+  }
+  return log_stream;
+}
+
+void flush_log(void) {
+  if (log_stream) {
+    fflush(log_stream);
+  }
+}
+
+void close_log(void) {
+  if (log_stream) {
+    fclose(log_stream);
+    log_stream = NULL;
+    free(log_buffer);
+    log_buffer = NULL;
+  }
+}
+
+OutputWriter* set_log_writer(OutputWriter* writer) {
+  OutputWriter* prev = log_writer;
+  log_writer = writer;
+  return prev;
+}
+
+jmp_buf* set_allocation_recovery(jmp_buf* env) {
+  jmp_buf* prev = allocation_recovery;
+  allocation_recovery = env;
+  return prev;
+}
+
+void recover_from_allocation_failure(void) {
+  if (allocation_recovery) {
+    longjmp(*allocation_recovery, 1);
+  }
+}
+
+/* Formats a message into LOG_WRITER. */
+static void vlog_to_writer(const char* fmt, va_list args) {
+  char buf[256];
+  va_list copy;
+  va_copy(copy, args);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  if (len >= 0 && (size_t)len < sizeof(buf)) {
+    writer_write(log_writer, buf, (size_t)len);
+  } else if (len >= 0) {
+    char* big = malloc((size_t)len + 1);
+    if (big) {
+      vsnprintf(big, (size_t)len + 1, fmt, copy);
+      writer_write(log_writer, big, (size_t)len);
+      free(big);
+    } else {
+      log_writer->error = 1;
+    }
+  }
+  va_end(copy);
+}
 
 int is_log_file_set(void) { return output_file != NULL; }
 
 void set_log_file(const char* filename) {
+  /* Messages for the previous file must land there. */
+  close_log();
   if (filename) {
     output_file = filename;
     unlink(filename);
@@ -28,8 +118,12 @@ void set_log_file(const char* filename) {
 void write_to_log(char* fmt, ...) {
   va_list args;
 
-  if (output_file) {
-    FILE* f = fopen(output_file, "a");
+  if (log_writer) {
+    va_start(args, fmt);
+    vlog_to_writer(fmt, args);
+    va_end(args);
+  } else if (output_file) {
+    FILE* f = open_log();
     if (!f) {
       return;
     }
@@ -37,7 +131,6 @@ void write_to_log(char* fmt, ...) {
     va_start(args, fmt);
     vfprintf(f, fmt, args);
     va_end(args);
-    fclose(f);
   } else {
     va_start(args, fmt);
     vfprintf(stderr, fmt, args);
@@ -48,18 +141,25 @@ void write_to_log(char* fmt, ...) {
 void log_inst(const char* name, char** args, int num_args) {
   int i;
 
-  if (output_file) {
-    FILE* f = fopen(output_file, "a");
+  if (log_writer) {
+    writer_write(log_writer, name, strlen(name));
+    for (i = 0; i < num_args; i++) {
+      writer_write(log_writer, " ", 1);
+      writer_write(log_writer, args[i], strlen(args[i]));
+    }
+    writer_write(log_writer, "\n", 1);
+  } else if (output_file) {
+    FILE* f = open_log();
     if (!f) {
       return;
     }
 
-    fprintf(f, "%s", name);
+    fputs(name, f);
     for (i = 0; i < num_args; i++) {
-      fprintf(f, " %s", args[i]);
+      fputc(' ', f);
+      fputs(args[i], f);
     }
-    fprintf(f, "\n");
-    fclose(f);
+    fputc('\n', f);
   } else {
     fprintf(stderr, "%s", name);
     for (i = 0; i < num_args; i++) {
@@ -68,3 +168,12 @@ void log_inst(const char* name, char** args, int num_args) {
     fprintf(stderr, "\n");
   }
 }
+
+uint32_t hash_string(const char* str) {
+  uint32_t hash = 2166136261u;
+  while (*str) {
+    hash ^= (unsigned char)*str++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
@@ -7,6 +7,11 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <setjmp.h>
+#include <stdint.h>
+
+#include "writer.h"
+
 /*******************************
  * Do Not Modify Code Below
  *******************************/
@@ -19,4 +24,39 @@ void write_to_log(char* fmt, ...);
 
 void log_inst(const char* name, char** args, int num_args);
 
+/*******************************
+ * Extended Interface
+ *******************************/
+
+/* The log file set with set_log_file() and the buffered messages belong to
+   the calling thread; other threads log independently. */
+
+/* Messages for the log file are buffered and written once this many bytes
+   have accumulated, or on flush_log()/close_log(). */
+#define LOG_BUFFER_SIZE (64 * 1024)
+
+/* Write any buffered log messages to the log file. */
+void flush_log(void);
+
+/* Flush and close the log file. The next message reopens it for appending,
+   so this is safe to call at any point. */
+void close_log(void);
+
+/* While WRITER is set, messages are appended to it instead of the log file
+   or stderr; NULL restores the usual destination. Returns the previous
+   writer, so calls can be nested. */
+OutputWriter* set_log_writer(OutputWriter* writer);
+
+/* allocation_failed() and block_allocation_failed() end the process unless
+   a recovery point has been installed here, in which case they longjmp() to
+   ENV instead. NULL removes it. Returns the previous recovery point. */
+jmp_buf* set_allocation_recovery(jmp_buf* env);
+
+/* Jumps to the recovery point, if any; otherwise returns. */
+void recover_from_allocation_failure(void);
+
+/* FNV-1a hash of a NUL-terminated string, shared by the hash tables of the
+   symbol table, the string arena and the backpatcher. */
+uint32_t hash_string(const char* str);
+
 #endif
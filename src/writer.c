@@ -0,0 +1,266 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "writer.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "stats.h"
+
+/* Initial buffer size of a memory writer. */
+#define MEMORY_WRITER_INITIAL_CAP 4096
+
+/* Most iovecs passed to one writev() call. */
+#define MAX_IOVECS 64
+
+/* Two uppercase hex digits for every byte value. */
+static const char hex_pairs[513] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+/*******************************
+ * Helper Functions
+ *******************************/
+
+/* Write all LEN bytes of DATA to FD, retrying short writes. */
+static int write_all(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+/* write_all() to WRITER's descriptor, timed into its io_time. */
+static int writer_write_all(OutputWriter* writer, const char* data,
+                            size_t len) {
+  if (!writer->io_time) {
+    return write_all(writer->fd, data, len);
+  }
+  PhaseTime start;
+  phase_time_now(&start);
+  int result = write_all(writer->fd, data, len);
+  phase_time_add_since(writer->io_time, &start);
+  return result;
+}
+
+/* Make room for at least NEED more bytes. Returns -1 if there is none. */
+static int reserve(OutputWriter* writer, size_t need) {
+  if (writer->error) {
+    return -1;
+  }
+  if (writer->cap - writer->len >= need) {
+    return 0;
+  }
+  if (writer->fd >= 0) {
+    if (writer_flush(writer) != 0) {
+      return -1;
+    }
+    if (writer->cap >= need) {
+      return 0;
+    }
+  }
+  size_t new_cap = writer->cap ? writer->cap : MEMORY_WRITER_INITIAL_CAP;
+  while (new_cap - writer->len < need) {
+    new_cap *= 2;
+  }
+  char* buf = realloc(writer->buf, new_cap);
+  if (!buf) {
+    writer->error = 1;
+    return -1;
+  }
+  writer->buf = buf;
+  writer->cap = new_cap;
+  return 0;
+}
+
+/*******************************
+ * Writer Functions
+ *******************************/
+
+void writer_init_fd(OutputWriter* writer, int fd) {
+  writer->fd = fd;
+  writer->buf = malloc(WRITER_BUF_SIZE);
+  writer->len = 0;
+  writer->cap = writer->buf ? WRITER_BUF_SIZE : 0;
+  writer->error = 0;
+  writer->word_format = WORD_HEX;
+  writer->io_time = NULL;
+}
+
+void writer_init_memory(OutputWriter* writer) {
+  writer->fd = -1;
+  writer->buf = NULL;
+  writer->len = 0;
+  writer->cap = 0;
+  writer->error = 0;
+  writer->word_format = WORD_HEX;
+  writer->io_time = NULL;
+}
+
+void writer_reset(OutputWriter* writer) {
+  writer->len = 0;
+  writer->error = 0;
+}
+
+void writer_write(OutputWriter* writer, const void* data, size_t len) {
+  if (writer->fd >= 0 && len >= WRITER_BUF_SIZE) {
+    /* Too big to be worth buffering. */
+    if (writer_flush(writer) == 0 &&
+        writer_write_all(writer, data, len) != 0) {
+      writer->error = 1;
+    }
+    return;
+  }
+  if (reserve(writer, len) != 0) {
+    return;
+  }
+  memcpy(writer->buf + writer->len, data, len);
+  writer->len += len;
+}
+
+void writer_put_hex(OutputWriter* writer, uint32_t word) {
+  if (reserve(writer, HEX_LINE_LEN) != 0) {
+    return;
+  }
+  char* p = writer->buf + writer->len;
+  p[0] = '0';
+  p[1] = 'x';
+  memcpy(p + 2, &hex_pairs[2 * (word >> 24)], 2);
+  memcpy(p + 4, &hex_pairs[2 * ((word >> 16) & 0xFF)], 2);
+  memcpy(p + 6, &hex_pairs[2 * ((word >> 8) & 0xFF)], 2);
+  memcpy(p + 8, &hex_pairs[2 * (word & 0xFF)], 2);
+  p[10] = '\n';
+  writer->len += HEX_LINE_LEN;
+}
+
+void writer_put_le32(OutputWriter* writer, uint32_t word) {
+  if (reserve(writer, 4) != 0) {
+    return;
+  }
+  unsigned char* p = (unsigned char*)writer->buf + writer->len;
+  p[0] = (unsigned char)word;
+  p[1] = (unsigned char)(word >> 8);
+  p[2] = (unsigned char)(word >> 16);
+  p[3] = (unsigned char)(word >> 24);
+  writer->len += 4;
+}
+
+void writer_put_word(OutputWriter* writer, uint32_t word) {
+  if (writer->word_format == WORD_BIN) {
+    writer_put_le32(writer, word);
+  } else {
+    writer_put_hex(writer, word);
+  }
+}
+
+void writer_put_half(OutputWriter* writer, uint16_t half) {
+  if (writer->word_format == WORD_BIN) {
+    unsigned char bytes[2] = {(unsigned char)half, (unsigned char)(half >> 8)};
+    writer_write(writer, bytes, 2);
+  } else {
+    char line[8];
+    line[0] = '0';
+    line[1] = 'x';
+    memcpy(line + 2, &hex_pairs[2 * (half >> 8)], 2);
+    memcpy(line + 4, &hex_pairs[2 * (half & 0xFF)], 2);
+    line[6] = '\n';
+    writer_write(writer, line, 7);
+  }
+}
+
+void writer_append(OutputWriter* writer, OutputWriter* parts, int count) {
+  if (writer->fd < 0) {
+    for (int i = 0; i < count; i++) {
+      writer_write(writer, parts[i].buf, parts[i].len);
+    }
+    return;
+  }
+  if (writer_flush(writer) != 0) {
+    return;
+  }
+
+  PhaseTime start = {0, 0};
+  if (writer->io_time) {
+    phase_time_now(&start);
+  }
+  struct iovec iov[MAX_IOVECS];
+  int i = 0;
+  while (i < count) {
+    int n = 0;
+    for (; i < count && n < MAX_IOVECS; i++) {
+      if (parts[i].len > 0) {
+        iov[n].iov_base = parts[i].buf;
+        iov[n].iov_len = parts[i].len;
+        n++;
+      }
+    }
+    /* writev() may stop early; finish the rest of the batch by hand. */
+    int first = 0;
+    while (first < n) {
+      ssize_t written = writev(writer->fd, iov + first, n - first);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        writer->error = 1;
+        i = count;
+        break;
+      }
+      while (first < n && (size_t)written >= iov[first].iov_len) {
+        written -= (ssize_t)iov[first].iov_len;
+        first++;
+      }
+      if (first < n) {
+        iov[first].iov_base = (char*)iov[first].iov_base + written;
+        iov[first].iov_len -= (size_t)written;
+      }
+    }
+  }
+  if (writer->io_time) {
+    phase_time_add_since(writer->io_time, &start);
+  }
+}
+
+int writer_flush(OutputWriter* writer) {
+  if (writer->fd >= 0 && writer->len > 0 && !writer->error) {
+    if (writer_write_all(writer, writer->buf, writer->len) != 0) {
+      writer->error = 1;
+    }
+    writer->len = 0;
+  }
+  return writer->error ? -1 : 0;
+}
+
+int writer_release(OutputWriter* writer) {
+  int result = writer_flush(writer);
+  free(writer->buf);
+  writer->buf = NULL;
+  writer->len = 0;
+  writer->cap = 0;
+  return result;
+}
@@ -0,0 +1,88 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of the buffer of a file-backed writer. */
+#define WRITER_BUF_SIZE (256 * 1024)
+
+/* Length of one formatted instruction, "0x%08X\n". */
+#define HEX_LINE_LEN 11
+
+struct PhaseTime;
+
+/* How writer_put_word() encodes an instruction word. */
+typedef enum {
+  WORD_HEX, /* "0x%08X\n" text lines */
+  WORD_BIN, /* 4 raw bytes, little-endian */
+} WordFormat;
+
+/* A buffered output sink for pass two.
+
+   A file-backed writer collects output in a WRITER_BUF_SIZE buffer and
+   hands it to write() when the buffer fills up or on writer_flush(). A
+   memory writer (FD < 0) instead grows its buffer and keeps everything, so
+   that it can later be appended to another writer in one go.
+ */
+typedef struct {
+  /* Destination file descriptor, or -1 for a memory writer. */
+  int fd;
+  char* buf;
+  size_t len;
+  size_t cap;
+  /* Set once an allocation or a write() fails; later output is dropped. */
+  int error;
+  /* Encoding used by writer_put_word(); WORD_HEX after initialization. */
+  WordFormat word_format;
+  /* If set, the time spent in write() and writev() is added to it (see
+     stats.h). NULL after initialization. */
+  struct PhaseTime* io_time;
+} OutputWriter;
+
+/* Initialize a writer that flushes to FD. FD is not closed by the writer. */
+void writer_init_fd(OutputWriter* writer, int fd);
+
+/* Initialize a writer that keeps its output in memory. */
+void writer_init_memory(OutputWriter* writer);
+
+/* Drop the contents of a memory writer (and any error), keeping its buffer
+   for reuse. */
+void writer_reset(OutputWriter* writer);
+
+/* Append LEN bytes from DATA. */
+void writer_write(OutputWriter* writer, const void* data, size_t len);
+
+/* Append WORD formatted as "0x%08X\n". */
+void writer_put_hex(OutputWriter* writer, uint32_t word);
+
+/* Append WORD as 4 little-endian bytes. */
+void writer_put_le32(OutputWriter* writer, uint32_t word);
+
+/* Append WORD in the writer's word_format. */
+void writer_put_word(OutputWriter* writer, uint32_t word);
+
+/* Append the compressed instruction HALF in the writer's word_format, as
+   "0x%04X" or 2 little-endian bytes. */
+void writer_put_half(OutputWriter* writer, uint16_t half);
+
+/* Append the contents of the memory writers PARTS[0..COUNT) in order. For a
+   file-backed WRITER the parts are passed to writev() directly instead of
+   being copied through its buffer. */
+void writer_append(OutputWriter* writer, OutputWriter* parts, int count);
+
+/* Write out any buffered data of a file-backed writer. Returns 0 on success
+   and -1 if any output was lost. */
+int writer_flush(OutputWriter* writer);
+
+/* Flush (if file-backed) and free the buffer. Returns writer_flush()'s
+   result. */
+int writer_release(OutputWriter* writer);
+
+#endif
@@ -0,0 +1,204 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+/* Test driver for assemble_buffer(), linked against libassembler.a.
+
+     buffer_driver IN OUT_PREFIX
+       Assembles the file IN in memory and writes OUT_PREFIX.out and
+       OUT_PREFIX.log, for comparison with the references of assemble().
+       Also checks that a short output buffer is reported and that a reused
+       AssembleContext gives the same results.
+
+     buffer_driver --fail_allocs IN
+       Assembles IN again and again, making the Nth heap allocation fail for
+       N = 1, 2, ... until a run needs fewer than N allocations. Every run
+       must return ASSEMBLE_ERR_NOMEM (or succeed), leak nothing and leave
+       later runs unaffected.
+
+   The allocator is wrapped with -Wl,--wrap=malloc,--wrap=calloc,
+   --wrap=realloc,--wrap=free to inject the failures and count live
+   allocations; the driver's own buffers bypass the wrappers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../assembler.h"
+
+/* Room for the outputs of every file in in/. */
+#define OUT_CAP (1 << 20)
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+/* Allocation number that fails (0 for none), allocations so far, and the
+   number of blocks allocated and not yet freed. */
+static long fail_at = 0;
+static long num_allocs = 0;
+static long live = 0;
+
+static int should_fail(void) { return ++num_allocs == fail_at; }
+
+static void* track(void* ptr) {
+  if (ptr) {
+    live++;
+  }
+  return ptr;
+}
+
+void* __wrap_malloc(size_t size) {
+  return should_fail() ? NULL : track(__real_malloc(size));
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  return should_fail() ? NULL : track(__real_calloc(count, size));
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  if (should_fail()) {
+    return NULL;
+  }
+  return ptr ? __real_realloc(ptr, size) : track(__real_realloc(ptr, size));
+}
+
+void __wrap_free(void* ptr) {
+  if (ptr) {
+    live--;
+  }
+  __real_free(ptr);
+}
+
+static char* read_file(const char* path, size_t* len) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  rewind(file);
+  char* data = __real_malloc(size > 0 ? (size_t)size : 1);
+  *len = data ? fread(data, 1, (size_t)size, file) : 0;
+  fclose(file);
+  return data;
+}
+
+static int write_file(const char* prefix, const char* ext, const char* data,
+                      size_t len) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s.%s", prefix, ext);
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    return -1;
+  }
+  fwrite(data, 1, len, file);
+  fclose(file);
+  return 0;
+}
+
+static int assemble_file(const char* in, const char* prefix) {
+  size_t len;
+  char* src = read_file(in, &len);
+  char* out = __real_malloc(OUT_CAP);
+  char* log = __real_malloc(OUT_CAP);
+  if (!src || !out || !log) {
+    fprintf(stderr, "%s: cannot read input\n", in);
+    return 1;
+  }
+
+  AssembleBuffers bufs = {out, OUT_CAP, 0, log, OUT_CAP, 0};
+  int status = assemble_buffer(src, len, NULL, &bufs);
+  if (status != ASSEMBLE_OK && status != ASSEMBLE_ERR_SOURCE) {
+    fprintf(stderr, "%s: assemble_buffer() returned %d\n", in, status);
+    return 1;
+  }
+  write_file(prefix, "out", out, bufs.out_len);
+  write_file(prefix, "log", log, bufs.log_len);
+
+  /* A too small output buffer is reported, with the size needed. */
+  AssembleBuffers small = {out, bufs.out_len / 2, 0, NULL, 0, 0};
+  if (bufs.out_len > 0 &&
+      (assemble_buffer(src, len, NULL, &small) != ASSEMBLE_ERR_SPACE ||
+       small.out_len != bufs.out_len || small.log_len != bufs.log_len)) {
+    fprintf(stderr, "%s: short buffer not reported\n", in);
+    return 1;
+  }
+
+  /* A reused context gives the same result, also after other sources. */
+  AssembleContext* ctx = create_assemble_context();
+  char* again = __real_malloc(OUT_CAP);
+  for (int i = 0; i < 3; i++) {
+    const char* other = "beq a0 a1 done\ndone: addi a0 a0 1\n";
+    AssembleBuffers reuse = {again, OUT_CAP, 0, NULL, 0, 0};
+    if (assemble_buffer_with_context(ctx, src, len, NULL, &reuse) != status ||
+        reuse.out_len != bufs.out_len || memcmp(again, out, bufs.out_len)) {
+      fprintf(stderr, "%s: output differs with a reused context\n", in);
+      return 1;
+    }
+    assemble_buffer_with_context(ctx, other, strlen(other), NULL, &reuse);
+  }
+  free_assemble_context(ctx);
+
+  __real_free(again);
+  __real_free(src);
+  __real_free(out);
+  __real_free(log);
+  return 0;
+}
+
+static int fail_allocs(const char* in) {
+  size_t len;
+  char* src = read_file(in, &len);
+  char* out = __real_malloc(OUT_CAP);
+  char* ref = __real_malloc(OUT_CAP);
+  if (!src || !out || !ref) {
+    fprintf(stderr, "%s: cannot read input\n", in);
+    return 1;
+  }
+
+  AssembleBuffers bufs = {ref, OUT_CAP, 0, NULL, 0, 0};
+  int expected = assemble_buffer(src, len, NULL, &bufs);
+  size_t ref_len = bufs.out_len;
+
+  for (fail_at = 1;; fail_at++) {
+    num_allocs = 0;
+    bufs = (AssembleBuffers){out, OUT_CAP, 0, NULL, 0, 0};
+    int status = assemble_buffer(src, len, NULL, &bufs);
+    if (num_allocs < fail_at) {
+      /* Nothing failed: the run must be unaffected by the earlier ones. */
+      if (status != expected || bufs.out_len != ref_len ||
+          memcmp(out, ref, ref_len) != 0) {
+        fprintf(stderr, "%s: output differs after failed runs\n", in);
+        return 1;
+      }
+      break;
+    }
+    if (status != ASSEMBLE_ERR_NOMEM || live != 0) {
+      fprintf(stderr, "%s: allocation %ld failed, returned %d, leaked %ld\n",
+              in, fail_at, status, live);
+      return 1;
+    }
+  }
+  printf("%s: %ld allocation failures recovered\n", in, fail_at - 1);
+  fail_at = 0;
+  __real_free(src);
+  __real_free(out);
+  __real_free(ref);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc == 3 && strcmp(argv[1], "--fail_allocs") == 0) {
+    return fail_allocs(argv[2]);
+  }
+  if (argc == 3) {
+    return assemble_file(argv[1], argv[2]);
+  }
+  fprintf(stderr, "usage: %s IN OUT_PREFIX | --fail_allocs IN\n", argv[0]);
+  return 2;
+}
@@ -0,0 +1,52 @@
+/* This project is based on the MIPS Assembler of CS61C in UC Berkeley.
+   The framework of this project is been modified to be suitable for RISC-V
+   in CS110 course in ShanghaiTech University by Zhijie Yang in March 2019.
+   Updated by Chibin Zhang and Zhe Ye in March 2021.
+*/
+
+/* Test driver for the mnemonic dispatch, linked against libassembler.a.
+
+     dispatch_driver
+       Looks up the name of every `instr_table` entry with find_instr_info()
+       and of every pseudo-instruction handler with find_pseudo_handler(),
+       and checks that each lookup returns that same entry. A KEY in
+       RV32_INSTRUCTIONS or PSEUDO_INSTRUCTIONS that does not spell its
+       NAME makes the lookup miss. Prints the mismatches and exits with 1 if
+       there are any.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/translate.h"
+
+int main(void) {
+  int failed = 0;
+  for (int id = 0; id < NUM_INSTRS; id++) {
+    const InstrInfo* info = instr_info((InstrId)id);
+    if (find_instr_info(info->name) != info) {
+      printf("instruction %d (%s) does not dispatch to itself\n", id,
+             info->name);
+      failed = 1;
+    }
+  }
+  for (int id = 0; id < NUM_PSEUDOS; id++) {
+    const char* name = pseudo_handler_name((PseudoId)id);
+    const PseudoHandler* handler = find_pseudo_handler(name);
+    if (!handler || handler->name != name) {
+      printf("pseudo-instruction %d (%s) does not dispatch to itself\n", id,
+             name);
+      failed = 1;
+    }
+  }
+  /* Names the switches must not accept. */
+  static const char* const others[] = {"", "addu", "nop", "lwu", "ecal",
+                                       "ecalls", "sltiuu", "x0"};
+  for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++) {
+    if (find_instr_info(others[i]) || find_pseudo_handler(others[i])) {
+      printf("%s is not an instruction but dispatches\n", others[i]);
+      failed = 1;
+    }
+  }
+  return failed;
+}
@@ -0,0 +1,709 @@
+addi x0 x0 0
+addi a0 a0 5
+addi a0 a0 -32
+addi a1 x0 31
+addi a2 a3 0
+addi sp sp -64
+addi sp sp 496
+addi s0 sp 1020
+addi s1 sp 4
+add a0 x0 a1
+add t0 t0 t1
+add t0 t1 t0
+sub s0 s0 s1
+xor a0 a0 a5
+or a1 a2 a1
+and a4 a4 a3
+andi a0 a0 -32
+andi a5 a5 31
+slli t3 t3 31
+srli a0 a0 1
+srai s1 s1 31
+lui a0 31
+lui a0 0xFFFE0
+lui t6 1
+lw a0 124(a1)
+lw s0 0(s1)
+lw t0 252(sp)
+lw ra 0(sp)
+sw a0 124(a1)
+sw t0 252(sp)
+sw a5 0(s0)
+jalr x0 ra 0
+jalr ra t0 0
+start:
+beq s0 zero near
+bne a5 x0 start
+jal zero near
+jal ra start
+jal t0 near
+beq t0 zero near
+blt a0 a1 near
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+addi a0 a0 1
+near:
+beq a0 zero far
+bne s1 zero start
+jal ra far
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+add s0 s0 s1
+far:
+jal zero start
+beq a2 zero start
+jalr x0 ra 0
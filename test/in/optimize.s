@@ -0,0 +1,61 @@
+# Redundancy the peephole pass (-O) removes, and near misses it must keep.
+start:
+  mv a0 a0                  # removed
+  addi t0 t0 0              # removed
+  add t1 t1 x0              # removed
+  add t1 x0 t1              # removed
+  addi x0 x0 0              # the canonical nop is kept
+  mv a0 a1                  # kept
+  addi t0 t0 1              # kept
+  li a1 5                   # removed, overwritten by the next li
+  li a1 7
+  li a2 1                   # kept, read by the addi after it
+  addi a2 a2 1
+  li a3 1                   # kept, the lw reads a3 as its base
+  lw a3 0(a3)
+  li a4 1                   # removed, the lw does not read a4
+  lw a4 4(sp)
+  li ra 9                   # removed, the jal overwrites ra
+  jal ra callee
+  li a5 3                   # kept, a label is at the overwrite
+again:
+  li a5 4
+  li a6 1                   # kept, ecall reads argument registers
+  ecall
+  li a6 2
+  lui s0 0                  # folded into addi s0 x0 -12
+  addi s0 s0 -12
+  lui s1 1                  # kept, 4096 - 2048 is out of range
+  addi s1 s1 -2048
+  lui s2 0                  # folded into addi s2 x0 2047
+  addi s2 s2 2047
+  lui s9 1048575            # kept, -4096 + 2047 is out of range
+  addi s9 s9 2047
+  lui s3 1                  # kept, the addi writes another register
+  addi s4 s3 1
+  li s5 100000              # lui/addi of li kept
+  j next                    # removed, jumps to the next instruction
+next:
+  j skip                    # removed once the mv below is gone
+  mv s6 s6
+skip:
+  beq a0 a1 16              # retargeted over the removed mv and li
+  mv s7 s7
+  li t2 1
+  li t2 2
+  addi t3 t3 1
+  bne a0 a1 -24             # retargeted to the removed mv s6 s6, now skip
+  j end                     # kept, a label is in between
+  mv s8 s8
+middle:
+  addi t4 t4 1
+  lw t5 start
+  jal x0 4                  # removed, a numeric jump to the next
+  jal x0 -4                 # kept, now a jump to itself as before
+  li t6 1                   # kept, bogus may read t6
+  bogus t6 t6               # not decoded, left alone
+  mv t6 t6                  # removed
+  beqz a0 nowhere
+end:
+callee:
+  jr ra
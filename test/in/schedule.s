@@ -0,0 +1,57 @@
+# Load-use and multiply stalls the scheduler (--schedule) hides, and the
+# orderings it must keep.
+start:
+  lw t0 0(a0)               # each load is used right after it
+  addi t0 t0 1
+  lw t1 4(a0)
+  addi t1 t1 2
+  lw t2 8(a0)
+  add t3 t0 t1
+  add t3 t3 t2
+  mul s0 a1 a2              # the multiply result is needed next
+  add s0 s0 a3
+  li s1 100000              # lui/addi pair stays together
+  mul s2 a4 a5
+  sub s3 s2 a1
+  sw t3 12(a0)              # stores keep their order with loads
+  lw t4 12(a0)
+  addi t4 t4 1
+  sw t4 16(a0)
+  div s4 a1 a2
+  addi s5 s4 1
+  lw t5 start               # auipc/lw pair stays together
+  add t6 t5 t5
+  beq t6 x0 skip            # a branch ends the run
+  lw a6 0(sp)
+  add a7 a6 a6
+  lw s6 4(sp)
+skip:
+  lw s7 8(sp)               # a label starts a new run
+  add s8 s7 s7
+  lw s9 12(sp)
+  add s10 s9 s9
+  ecall
+  lw s11 0(a0)
+  addi s11 s11 1
+  xori a0 a0 1
+  slli a1 a1 2
+  bne a0 a1 -8              # its target starts a run
+  lw t0 0(a0)
+  addi t0 t0 1
+  lw t1 0(a1)
+  addi t1 t1 1
+  auipc ra start            # auipc stays right before its jalr
+  jalr ra ra start
+  lw t2 0(a2)
+  ori t2 t2 1
+  andi t3 t3 1
+  bogus a0
+  lw t3 0(a3)
+  addi t3 t3 1
+  slti t4 t4 1
+  auipc t1 0                # a plain auipc keeps its address
+  lw t0 0(s0)
+  addi s1 t0 1
+  addi a0 a0 1
+  addi a1 a1 1
+  jalr ra t1 0
@@ -0,0 +1,14 @@
+# Tokenizer edge cases: block-straddling comments, separators and labels
+start:	addi	sp,sp,-16								# comment that runs well past one 32-byte block
+  sw ra,12(sp)#no space before the comment
+  lw	a0,4(sp)
+  lw a1 0 ( sp )
+add a0,a0,a1
+# a comment line with, separators (and) : colons
+loop:
+                                                bnez a0, loop                                        # padded
+
+mid: mv a2,a0,
+  beq a0,x0,start##double
+last:jal loop
+end: j end
\ No newline at end of file
@@ -0,0 +1,5 @@
+
+	li t0, 3
+	  slt a2, t1, t0
+	                  sltu a2, t1, t0
+	  # sll t3, t2, t4
\ No newline at end of file
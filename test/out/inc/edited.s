@@ -0,0 +1,1321 @@
+add ra sp zero
+sub t0 tp gp
+addi t0 t0 1
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label11:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label12:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label12
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label11
+jalr ra
+lw s1 label11
+
+beq a0 a1 label11
+bne a1 a2 label12
+blt a2 a3 label11
+bge a4 a5 label12
+bltu s1 s2 label11
+bgeu s4 s5 label12
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label21:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label22:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label22
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label21
+jalr ra
+lw s1 label21
+
+beq a0 a1 label21
+bne a1 a2 label22
+blt a2 a3 label21
+bge a4 a5 label22
+bltu s1 s2 label21
+bgeu s4 s5 label22
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label32:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label32
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label31
+jalr ra
+lw s1 label31
+
+beq a0 a1 label31
+bne a1 a2 label32
+blt a2 a3 label31
+bge a4 a5 label32
+bltu s1 s2 label31
+bgeu s4 s5 label32
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label41:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label42:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label42
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label41
+jalr ra
+lw s1 label41
+
+beq a0 a1 label41
+bne a1 a2 label42
+blt a2 a3 label41
+bge a4 a5 label42
+bltu s1 s2 label41
+bgeu s4 s5 label42
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label51:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label52:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label52
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label51
+jalr ra
+lw s1 label51
+
+beq a0 a1 label51
+bne a1 a2 label52
+blt a2 a3 label51
+bge a4 a5 label52
+bltu s1 s2 label51
+bgeu s4 s5 label52
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label61:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label62:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label62
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label61
+jalr ra
+lw s1 label61
+
+beq a0 a1 label61
+bne a1 a2 label62
+blt a2 a3 label61
+bge a4 a5 label62
+bltu s1 s2 label61
+bgeu s4 s5 label62
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label71:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label72:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label72
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label71
+jalr ra
+lw s1 label71
+
+beq a0 a1 label71
+bne a1 a2 label72
+blt a2 a3 label71
+bge a4 a5 label72
+bltu s1 s2 label71
+bgeu s4 s5 label72
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label81:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label82:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label82
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label81
+jalr ra
+lw s1 label81
+
+beq a0 a1 label81
+bne a1 a2 label82
+blt a2 a3 label81
+bge a4 a5 label82
+bltu s1 s2 label81
+bgeu s4 s5 label82
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label91:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label92:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label92
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label91
+jalr ra
+lw s1 label91
+
+beq a0 a1 label91
+bne a1 a2 label92
+blt a2 a3 label91
+bge a4 a5 label92
+bltu s1 s2 label91
+bgeu s4 s5 label92
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label101:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label102:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label102
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label101
+jalr ra
+lw s1 label101
+
+beq a0 a1 label101
+bne a1 a2 label102
+blt a2 a3 label101
+bge a4 a5 label102
+bltu s1 s2 label101
+bgeu s4 s5 label102
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label111:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label112:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label112
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label111
+jalr ra
+lw s1 label111
+
+beq a0 a1 label111
+bne a1 a2 label112
+blt a2 a3 label111
+bge a4 a5 label112
+bltu s1 s2 label111
+bgeu s4 s5 label112
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label121:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label122:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label122
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label121
+jalr ra
+lw s1 label121
+
+beq a0 a1 label121
+bne a1 a2 label122
+blt a2 a3 label121
+bge a4 a5 label122
+bltu s1 s2 label121
+bgeu s4 s5 label122
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label131:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label132:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label132
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label131
+jalr ra
+lw s1 label131
+
+beq a0 a1 label131
+bne a1 a2 label132
+blt a2 a3 label131
+bge a4 a5 label132
+bltu s1 s2 label131
+bgeu s4 s5 label132
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label141:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label142:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label142
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label141
+jalr ra
+lw s1 label141
+
+beq a0 a1 label141
+bne a1 a2 label142
+blt a2 a3 label141
+bge a4 a5 label142
+bltu s1 s2 label141
+bgeu s4 s5 label142
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label151:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label152:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label152
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label151
+jalr ra
+lw s1 label151
+
+beq a0 a1 label151
+bne a1 a2 label152
+blt a2 a3 label151
+bge a4 a5 label152
+bltu s1 s2 label151
+bgeu s4 s5 label152
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label161:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label162:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label162
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label161
+jalr ra
+lw s1 label161
+
+beq a0 a1 label161
+bne a1 a2 label162
+blt a2 a3 label161
+bge a4 a5 label162
+bltu s1 s2 label161
+bgeu s4 s5 label162
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label171:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label172:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label172
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label171
+jalr ra
+lw s1 label171
+
+beq a0 a1 label171
+bne a1 a2 label172
+blt a2 a3 label171
+bge a4 a5 label172
+bltu s1 s2 label171
+bgeu s4 s5 label172
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label181:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label182:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label182
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label181
+jalr ra
+lw s1 label181
+
+beq a0 a1 label181
+bne a1 a2 label182
+blt a2 a3 label181
+bge a4 a5 label182
+bltu s1 s2 label181
+bgeu s4 s5 label182
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label191:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label192:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label192
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label191
+jalr ra
+lw s1 label191
+
+beq a0 a1 label191
+bne a1 a2 label192
+blt a2 a3 label191
+bge a4 a5 label192
+bltu s1 s2 label191
+bgeu s4 s5 label192
+
+add ra sp zero
+sub t0 tp gp
+xor t1 t2 t3 
+or t4 t5 t6
+sll s0 s1 s2
+srl s3 s4 s5
+sra s6 s7 s8
+slt s9 s10 s11
+sltu a0 a1 fp
+
+label201:
+mul a1 a2 a3
+mulh a4 a5 a6
+div a7 x0 x1
+rem x3 x4 x5
+addi x6 x7 -20
+xori x8 x9 10
+
+label202:
+ori  x11 x12 10
+andi x13 x14 12
+slli x15 x16 1
+srli x17 x18 2
+srai x19 x20 1
+slti x21 x22 2
+sltiu x23 x24 4
+lb x25 3(x26)
+lh x27 0(x28)
+lw x29 2(x30)
+lbu x31 9(x2)
+lhu t1 2(t2) 
+jalr x1 t2 0
+ecall
+
+sb a0 0(sp)
+sh a0 2(sp)
+sw a0 4(sp)
+
+beq a0 a1 4
+bne a1 a2 8
+blt a2 a3 12
+bge a4 a5 -20
+bltu s1 s2 16
+bgeu s4 s5 10
+
+lui x30 107592
+auipc a1 717430
+jal x13 label202
+
+beqz x1 -4
+bnez x2 -8
+li x1 30
+mv s1 a1
+j -20
+jr ra
+jal label201
+jalr ra
+lw s1 label201
+
+beq a0 a1 label201
+bne a1 a2 label202
+blt a2 a3 label201
+bge a4 a5 label202
+bltu s1 s2 label201
+bgeu s4 s5 label202
+
+jal label31
@@ -0,0 +1,59 @@
+  add ra sp zero                # 00000000: 000100B3
+  sub t0 tp gp                  # 00000004: 403202B3
+  xor t1 t2 t3                  # 00000008: 01C3C333
+  or t4 t5 t6                   # 0000000C: 01FF6EB3
+  sll s0 s1 s2                  # 00000010: 01249433
+  srl s3 s4 s5                  # 00000014: 015A59B3
+  sra s6 s7 s8                  # 00000018: 418BDB33
+  slt s9 s10 s11                # 0000001C: 01BD2CB3
+  sltu a0 a1 s0                 # 00000020: 0085B533
+label1:
+  mul a1 a2 a3                  # 00000024: 02D605B3
+  mulh a4 a5 a6                 # 00000028: 03079733
+  div a7 zero ra                # 0000002C: 021048B3
+  rem gp tp t0                  # 00000030: 025261B3
+  addi t1 t2 -20                # 00000034: FEC38313
+  xori s0 s1 10                 # 00000038: 00A4C413
+label2:
+  ori a1 a2 10                  # 0000003C: 00A66593
+  andi a3 a4 12                 # 00000040: 00C77693
+  slli a5 a6 1                  # 00000044: 00181793
+  srli a7 s2 2                  # 00000048: 00295893
+  srai s3 s4 1                  # 0000004C: 401A5993
+  slti s5 s6 2                  # 00000050: 002B2A93
+  sltiu s7 s8 4                 # 00000054: 004C3B93
+  lb s9 3(s10)                  # 00000058: 003D0C83
+  lh s11 0(t3)                  # 0000005C: 000E1D83
+  lw t4 2(t5)                   # 00000060: 002F2E83
+  lbu t6 9(sp)                  # 00000064: 00914F83
+  lhu t1 2(t2)                  # 00000068: 0023D303
+  jalr ra t2 0                  # 0000006C: 000380E7
+  ecall                         # 00000070: 00000073
+  sb a0 0(sp)                   # 00000074: 00A10023
+  sh a0 2(sp)                   # 00000078: 00A11123
+  sw a0 4(sp)                   # 0000007C: 00A12223
+  beq a0 a1 4                   # 00000080: 00B50263
+  bne a1 a2 8                   # 00000084: 00C59463
+  blt a2 a3 12                  # 00000088: 00D64663
+  bge a4 a5 -20                 # 0000008C: FEF756E3
+  bltu s1 s2 16                 # 00000090: 0124E863
+  bgeu s4 s5 10                 # 00000094: 015A7563
+  lui t5 107592                 # 00000098: 1A448F37
+  auipc a1 717430               # 0000009C: AF276597
+  jal a3 label2                 # 000000A0: F9DFF6EF
+  beq ra zero -4                # 000000A4: FE008EE3
+  bne sp zero -8                # 000000A8: FE011CE3
+  addi ra zero 30               # 000000AC: 01E00093
+  addi s1 a1 0                  # 000000B0: 00058493
+  jal zero -20                  # 000000B4: FEDFF06F
+  jalr zero ra 0                # 000000B8: 00008067
+  jal ra label1                 # 000000BC: F69FF0EF
+  jalr ra ra 0                  # 000000C0: 000080E7
+  auipc s1 0                    # 000000C4: 00000497
+  lw s1 -160(s1)                # 000000C8: F604A483
+  beq a0 a1 label1              # 000000CC: F4B50CE3
+  bne a1 a2 label2              # 000000D0: F6C596E3
+  blt a2 a3 label1              # 000000D4: F4D648E3
+  bge a4 a5 label2              # 000000D8: F6F752E3
+  bltu s1 s2 label1             # 000000DC: F524E4E3
+  bgeu s4 s5 label2             # 000000E0: F55A7EE3
@@ -0,0 +1,4 @@
+label1:
+label3:
+  beq t0 t1 label2              # 00000000: 00628263
+label2: